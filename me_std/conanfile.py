@@ -17,10 +17,10 @@ class MeStdConan(ConanFile):
     description = "My (Markus Eggenbauer) personal standard template library"
     topics = ("C++", "library")
     settings = "os", "compiler", "build_type", "arch"
-    options = {"shared": [True, False], "fPIC": [True, False]}
-    default_options = {"shared": False, "fPIC": True}
-    build_requires = "gtest/1.10.0"
-    requires = "me_find_package/[~=1]", "me_build/[~=1]", "gtest/1.10.0"
+    # me_find_package and me_build are used by consumers and the test_package
+    # alike. The test libraries only build the tests of the package itself.
+    requires = "me_find_package/[~=1]", "me_build/[~=1]"
+    build_requires = "gtest/1.10.0", "benchmark/1.5.3"
     generators = "cmake_find_package"
     exports_sources = "CMakeLists.txt", "impl/*"
 
@@ -28,22 +28,18 @@ class MeStdConan(ConanFile):
         git = tools.Git(folder=self.recipe_folder)
         self.version = "%s" % (git.get_tag() or git.get_branch())
 
-    def config_options(self):
-        if self.settings.os == "Windows":
-            del self.options.fPIC
-
+    # Nothing is compiled into the package, but the tests are built and run.
     def build(self):
         cmake = CMake(self)
         cmake.configure()
-        self.run("cmake --build . --target me_std %s" % cmake.build_config)
+        cmake.build()
+        cmake.test()
 
     def package(self):
         self.copy("*.hpp", dst="include", src="impl/inc")
-        self.copy("*.so*", dst="lib", src="")
-        self.copy("*.a*", dst="lib", src="")
-        self.copy("*.dll", dst="lib", src="")
-        self.copy("*.lib", dst="lib", src="")
+
+    def package_id(self):
+        self.info.header_only()
 
     def package_info(self):
-        self.cpp_info.libs = ["me_std"]
         self.cpp_info.includedirs = ['include']
@@ -0,0 +1,340 @@
+#ifndef ME_STD_ATOMIC_OPTIONAL_REF_HPP
+#define ME_STD_ATOMIC_OPTIONAL_REF_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <functional>
+#include <me_std/optional_ref.hpp>
+#include <memory>
+#include <mutex>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace me_std {
+
+namespace detail {
+
+// A slot in which one reader publishes the pointer it is about to dereference.
+// Slots are owned by one thread at a time and live until the program ends.
+struct alignas(64) hazard_record {
+  std::atomic<void const *> pointer{nullptr};
+  std::atomic<bool> active{false};
+  hazard_record *next{nullptr};
+};
+
+struct retired_pointer {
+  void const *pointer;
+  std::function<void()> reclaim;
+};
+
+class hazard_registry {
+ public:
+  static hazard_registry &instance() {
+    static hazard_registry registry{};
+    return registry;
+  }
+
+  hazard_registry(hazard_registry const &) = delete;
+  hazard_registry &operator=(hazard_registry const &) = delete;
+
+  // No reader is left once the registry is destroyed.
+  ~hazard_registry() {
+    for (auto &orphan : m_orphans) {
+      orphan.reclaim();
+    }
+    for (auto *record = m_head.load(std::memory_order_acquire); record != nullptr;) {
+      delete std::exchange(record, record->next);
+    }
+  }
+
+  hazard_record *acquire() {
+    for (auto *record = m_head.load(std::memory_order_acquire); record != nullptr;
+         record = record->next) {
+      bool expected{false};
+      if (!record->active.load(std::memory_order_relaxed) &&
+          record->active.compare_exchange_strong(expected, true, std::memory_order_acq_rel)) {
+        return record;
+      }
+    }
+    auto *const record = new hazard_record{};
+    record->active.store(true, std::memory_order_relaxed);
+    auto *head = m_head.load(std::memory_order_relaxed);
+    do {
+      record->next = head;
+    } while (!m_head.compare_exchange_weak(head, record, std::memory_order_release,
+                                           std::memory_order_relaxed));
+    m_record_count.fetch_add(1U, std::memory_order_relaxed);
+    return record;
+  }
+
+  void release(hazard_record *record) noexcept {
+    record->pointer.store(nullptr, std::memory_order_release);
+    record->active.store(false, std::memory_order_release);
+  }
+
+  std::size_t record_count() const noexcept {
+    return m_record_count.load(std::memory_order_relaxed);
+  }
+
+  // Reclaims the retired pointers no reader has published, keeps the others.
+  void scan(std::vector<retired_pointer> &retired) {
+    adopt_orphans(retired);
+    std::vector<void const *> hazards{};
+    for (auto *record = m_head.load(std::memory_order_acquire); record != nullptr;
+         record = record->next) {
+      if (auto const *const pointer = record->pointer.load(std::memory_order_seq_cst)) {
+        hazards.push_back(pointer);
+      }
+    }
+    std::sort(hazards.begin(), hazards.end());
+
+    auto const kept = std::stable_partition(
+        retired.begin(), retired.end(), [&hazards](retired_pointer const &entry) {
+          return std::binary_search(hazards.begin(), hazards.end(), entry.pointer);
+        });
+    std::vector<retired_pointer> reclaimed{std::make_move_iterator(kept),
+                                           std::make_move_iterator(retired.end())};
+    retired.erase(kept, retired.end());
+    for (auto &entry : reclaimed) {
+      entry.reclaim();
+    }
+  }
+
+  // Pointers retired by a thread that ended while they were still protected.
+  void orphan(std::vector<retired_pointer> &retired) {
+    std::lock_guard<std::mutex> const lock{m_orphan_mutex};
+    std::move(retired.begin(), retired.end(), std::back_inserter(m_orphans));
+    m_has_orphans.store(true, std::memory_order_release);
+    retired.clear();
+  }
+
+ private:
+  hazard_registry() = default;
+
+  void adopt_orphans(std::vector<retired_pointer> &retired) {
+    if (!m_has_orphans.load(std::memory_order_acquire)) {
+      return;
+    }
+    std::lock_guard<std::mutex> const lock{m_orphan_mutex};
+    std::move(m_orphans.begin(), m_orphans.end(), std::back_inserter(retired));
+    m_orphans.clear();
+    m_has_orphans.store(false, std::memory_order_relaxed);
+  }
+
+  std::atomic<hazard_record *> m_head{nullptr};
+  std::atomic<std::size_t> m_record_count{0};
+  std::mutex m_orphan_mutex{};
+  std::atomic<bool> m_has_orphans{false};
+  std::vector<retired_pointer> m_orphans{};
+};
+
+// The hazard records and retired pointers of the calling thread. Records are
+// kept for reuse, so protecting a referent does not touch shared state beyond
+// the thread's own record.
+class hazard_thread {
+ public:
+  static hazard_thread &instance() {
+    thread_local hazard_thread thread{};
+    return thread;
+  }
+
+  hazard_thread(hazard_thread const &) = delete;
+  hazard_thread &operator=(hazard_thread const &) = delete;
+
+  ~hazard_thread() {
+    auto &registry = hazard_registry::instance();
+    for (auto *record : m_free) {
+      registry.release(record);
+    }
+    if (!m_retired.empty()) {
+      registry.scan(m_retired);
+    }
+    if (!m_retired.empty()) {
+      registry.orphan(m_retired);
+    }
+  }
+
+  hazard_record *acquire() {
+    if (m_free.empty()) {
+      return hazard_registry::instance().acquire();
+    }
+    auto *const record = m_free.back();
+    m_free.pop_back();
+    return record;
+  }
+
+  void release(hazard_record *record) noexcept {
+    record->pointer.store(nullptr, std::memory_order_release);
+    m_free.push_back(record);
+  }
+
+  void retire(retired_pointer entry) {
+    m_retired.push_back(std::move(entry));
+    auto &registry = hazard_registry::instance();
+    if (m_retired.size() >= std::max<std::size_t>(64U, 2U * registry.record_count())) {
+      registry.scan(m_retired);
+    }
+  }
+
+  void reclaim() { hazard_registry::instance().scan(m_retired); }
+
+ private:
+  hazard_thread() { m_free.reserve(4U); }
+
+  std::vector<hazard_record *> m_free{};
+  std::vector<retired_pointer> m_retired{};
+};
+
+}  // namespace detail
+
+// An optional_ref whose referent is published in a hazard record, so it is not
+// reclaimed through hazard_retire while the hazard_ref lives.
+template <typename T>
+class hazard_ref {
+  static_assert(std::is_lvalue_reference<T>::value == true,
+                "Template argument T must be a reference type.");
+
+ public:
+  using value_type = std::decay_t<T>;
+  using reference_type = T;
+  using pointer_type = std::remove_reference_t<T> *;
+
+  hazard_ref(hazard_ref &&other) noexcept
+      : m_record{std::exchange(other.m_record, nullptr)}, m_value{other.m_value} {}
+  hazard_ref(hazard_ref const &) = delete;
+  hazard_ref &operator=(hazard_ref const &) = delete;
+  hazard_ref &operator=(hazard_ref &&) = delete;
+  ~hazard_ref() {
+    if (m_record != nullptr) {
+      detail::hazard_thread::instance().release(m_record);
+    }
+  }
+
+  bool has_value() const noexcept { return m_value != nullptr; }
+  reference_type operator*() const noexcept { return *m_value; }
+  pointer_type operator->() const noexcept { return m_value; }
+
+  // The protected referent, valid as long as this hazard_ref lives.
+  optional_ref<T> get() const noexcept {
+    return has_value() ? optional_ref<T>{*m_value} : optional_ref<T>{};
+  }
+
+ private:
+  template <typename>
+  friend class atomic_optional_ref;
+
+  hazard_ref(detail::hazard_record *record, pointer_type value) noexcept
+      : m_record{record}, m_value{value} {}
+
+  detail::hazard_record *m_record;
+  pointer_type m_value;
+};
+
+// An optional_ref that can be loaded and rebound concurrently. All operations
+// work on a single atomic pointer. Readers that may race with the reclamation
+// of a previous referent use protect() instead of load(), writers hand the
+// referents they replaced to hazard_retire.
+template <typename T>
+class atomic_optional_ref {
+  static_assert(std::is_lvalue_reference<T>::value == true,
+                "Template argument T must be a reference type.");
+
+ public:
+  using value_type = optional_ref<T>;
+  using reference_type = T;
+  using pointer_type = std::remove_reference_t<T> *;
+
+  static constexpr bool is_always_lock_free = std::atomic<pointer_type>::is_always_lock_free;
+
+  atomic_optional_ref() noexcept = default;
+  atomic_optional_ref(value_type value) noexcept : m_value{pointer_of(value)} {}
+  atomic_optional_ref(atomic_optional_ref const &) = delete;
+  atomic_optional_ref &operator=(atomic_optional_ref const &) = delete;
+
+  bool is_lock_free() const noexcept { return m_value.is_lock_free(); }
+
+  value_type load(std::memory_order order = std::memory_order_seq_cst) const noexcept {
+    return make_ref(m_value.load(order));
+  }
+
+  void store(value_type value, std::memory_order order = std::memory_order_seq_cst) noexcept {
+    m_value.store(pointer_of(value), order);
+  }
+
+  value_type exchange(value_type value,
+                      std::memory_order order = std::memory_order_seq_cst) noexcept {
+    return make_ref(m_value.exchange(pointer_of(value), order));
+  }
+
+  bool compare_exchange_weak(value_type &expected, value_type desired,
+                             std::memory_order order = std::memory_order_seq_cst) noexcept {
+    return compare_exchange(expected, desired, [order](auto &value, auto &current, auto next) {
+      return value.compare_exchange_weak(current, next, order);
+    });
+  }
+
+  bool compare_exchange_strong(value_type &expected, value_type desired,
+                               std::memory_order order = std::memory_order_seq_cst) noexcept {
+    return compare_exchange(expected, desired, [order](auto &value, auto &current, auto next) {
+      return value.compare_exchange_strong(current, next, order);
+    });
+  }
+
+  // Loads the current referent and keeps it from being reclaimed until the
+  // returned hazard_ref is destroyed.
+  hazard_ref<T> protect() const {
+    auto *const record = detail::hazard_thread::instance().acquire();
+    auto value = m_value.load(std::memory_order_relaxed);
+    for (;;) {
+      record->pointer.store(value, std::memory_order_seq_cst);
+      auto const current = m_value.load(std::memory_order_seq_cst);
+      if (current == value) {
+        return hazard_ref<T>{record, value};
+      }
+      value = current;
+    }
+  }
+
+ private:
+  static pointer_type pointer_of(value_type value) noexcept {
+    return value.has_value() ? value.operator->() : nullptr;
+  }
+
+  static value_type make_ref(pointer_type value) noexcept {
+    return (value != nullptr) ? value_type{*value} : value_type{};
+  }
+
+  template <typename Exchange>
+  bool compare_exchange(value_type &expected, value_type desired, Exchange exchange) noexcept {
+    auto current = pointer_of(expected);
+    if (exchange(m_value, current, pointer_of(desired))) {
+      return true;
+    }
+    expected = make_ref(current);
+    return false;
+  }
+
+  std::atomic<pointer_type> m_value{nullptr};
+};
+
+// Hands a referent that has been replaced in every atomic_optional_ref to the
+// calling thread. It is destroyed through deleter once no hazard_ref protects
+// it anymore, at the latest when the program ends.
+template <typename T, typename Deleter = std::default_delete<T>>
+void hazard_retire(T *value, Deleter deleter = Deleter{}) {
+  if (value == nullptr) {
+    return;
+  }
+  detail::hazard_thread::instance().retire(detail::retired_pointer{
+      value, [value, deleter = std::move(deleter)]() mutable { deleter(value); }});
+}
+
+// Destroys the referents retired by the calling thread that are no longer
+// protected.
+inline void hazard_reclaim() { detail::hazard_thread::instance().reclaim(); }
+
+}  // namespace me_std
+
+#endif  // ME_STD_ATOMIC_OPTIONAL_REF_HPP
@@ -0,0 +1,75 @@
+#ifndef ME_STD_COMPARE_TRAITS_HPP
+#define ME_STD_COMPARE_TRAITS_HPP
+
+#include <optional>
+#include <type_traits>
+#include <utility>
+
+namespace me_std::detail {
+
+template <typename Lhs, typename Rhs, typename = void>
+struct is_equality_comparable : std::false_type {};
+
+template <typename Lhs, typename Rhs>
+struct is_equality_comparable<
+    Lhs, Rhs, std::void_t<decltype(std::declval<Lhs const &>() == std::declval<Rhs const &>())>>
+    : std::true_type {};
+
+template <typename Lhs, typename Rhs, typename = void>
+struct is_less_comparable : std::false_type {};
+
+template <typename Lhs, typename Rhs>
+struct is_less_comparable<
+    Lhs, Rhs, std::void_t<decltype(std::declval<Lhs const &>() < std::declval<Rhs const &>())>>
+    : std::true_type {};
+
+// Specialized for optional_ref and safe_ref, whose comparisons with each
+// other are not provided.
+template <typename T>
+struct is_ref_wrapper : std::false_type {};
+
+template <typename T>
+struct is_std_optional : std::false_type {};
+
+template <typename T>
+struct is_std_optional<std::optional<T>> : std::true_type {};
+
+// An operand compared with the referent of a ref wrapper as it is.
+template <typename U>
+constexpr bool is_plain_operand = !is_ref_wrapper<U>::value && !is_std_optional<U>::value;
+
+// The comparisons of a ref wrapper to a T with a U, in both directions.
+template <typename T, typename U>
+constexpr bool is_ref_equality_comparable = is_plain_operand<U> &&
+                                            is_equality_comparable<std::decay_t<T>, U>::value &&
+                                            is_equality_comparable<U, std::decay_t<T>>::value;
+
+template <typename T, typename U>
+constexpr bool is_ref_less_comparable = is_plain_operand<U> &&
+                                        is_less_comparable<std::decay_t<T>, U>::value &&
+                                        is_less_comparable<U, std::decay_t<T>>::value;
+
+template <typename T, typename U>
+using enable_if_ref_equality_comparable = std::enable_if_t<is_ref_equality_comparable<T, U>>;
+
+template <typename T, typename U>
+using enable_if_ref_less_comparable = std::enable_if_t<is_ref_less_comparable<T, U>>;
+
+template <typename T, typename U>
+using enable_if_ref_ordered =
+    std::enable_if_t<is_ref_equality_comparable<T, U> && is_ref_less_comparable<T, U>>;
+
+template <typename T, typename U>
+using enable_if_optional_equality_comparable =
+    std::enable_if_t<is_equality_comparable<std::decay_t<T>, U>::value &&
+                     is_equality_comparable<U, std::decay_t<T>>::value>;
+
+template <typename T, typename U>
+using enable_if_optional_ordered = std::enable_if_t<
+    is_equality_comparable<std::decay_t<T>, U>::value &&
+    is_equality_comparable<U, std::decay_t<T>>::value &&
+    is_less_comparable<std::decay_t<T>, U>::value && is_less_comparable<U, std::decay_t<T>>::value>;
+
+}  // namespace me_std::detail
+
+#endif  // ME_STD_COMPARE_TRAITS_HPP
@@ -0,0 +1,528 @@
+#ifndef ME_STD_DEFERRED_REF_HPP
+#define ME_STD_DEFERRED_REF_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <me_std/compare_traits.hpp>
+#include <me_std/safe_ref_stats.hpp>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <type_traits>
+#include <utility>
+#if __has_include(<compare>)
+#include <compare>
+#endif
+
+namespace me_std {
+
+// Whether the borrowers of a ref_source may live on other threads than it.
+enum class ref_threading {
+  single_threaded,  // The source and all its borrowers stay on one thread.
+  thread_safe       // Borrowers may be copied and destroyed on any thread.
+};
+
+template <typename T, ref_threading Threading = ref_threading::single_threaded>
+class ref_source;
+
+template <typename T, ref_threading Threading = ref_threading::single_threaded>
+class deferred_ref;
+
+namespace detail {
+
+// A pointer a thread-safe borrower publishes to other threads.
+template <typename P, ref_threading Threading>
+using ref_slot =
+    std::conditional_t<Threading == ref_threading::thread_safe, std::atomic<P>, P>;
+
+template <typename P>
+P load_slot(P const &slot) noexcept {
+  return slot;
+}
+
+template <typename P>
+P load_slot(std::atomic<P> const &slot) noexcept {
+  return slot.load(std::memory_order_acquire);
+}
+
+template <typename P>
+void store_slot(P &slot, P value) noexcept {
+  slot = value;
+}
+
+template <typename P>
+void store_slot(std::atomic<P> &slot, P value) noexcept {
+  slot.store(value, std::memory_order_release);
+}
+
+// Stands in for the lock of a single-threaded source. The user-provided
+// destructor keeps -Wunused-but-set-variable quiet about the `auto const lock`
+// that is only held for its scope, as it is for a std::unique_lock.
+struct no_lock {
+  ~no_lock() {}
+};
+
+// Striped by the address of the source, so a borrower may lock it without
+// dereferencing a source that is being destroyed.
+inline std::unique_lock<std::mutex> lock_ref_source(void const *source,
+                                                    std::true_type /*thread_safe*/) {
+  static std::mutex mutexes[64];
+  return std::unique_lock<std::mutex>{
+      mutexes[(reinterpret_cast<std::uintptr_t>(source) / 64U) % 64U]};
+}
+
+inline no_lock lock_ref_source(void const *, std::false_type /*thread_safe*/) noexcept {
+  return no_lock{};
+}
+
+template <ref_threading Threading>
+auto lock_ref_source(void const *source) {
+  return lock_ref_source(source,
+                         std::integral_constant<bool, Threading == ref_threading::thread_safe>{});
+}
+
+}  // namespace detail
+
+// Owns a value and lends it to deferred_refs. The borrowers refer to the value
+// until it is about to be modified through modify(), moved from or destroyed.
+// Only then they get a snapshot, one shared by all of them. Its storage is
+// allocated when the first borrower attaches, so destroying the source never
+// allocates: it moves the value into the snapshot, or copies it if the move may
+// throw.
+//
+// In the thread-safe mode borrowers may be copied and destroyed on other
+// threads while the source takes the snapshot. Reading the value while it is
+// modified remains a data race, as with any reference.
+template <typename T, ref_threading Threading>
+class ref_source {
+  static_assert(std::is_same<T, std::decay_t<T>>::value,
+                "Template argument T must be a value type.");
+  static_assert(std::is_nothrow_move_constructible<T>::value ||
+                    std::is_nothrow_copy_constructible<T>::value,
+                "The destructor hands the value to the borrowers without throwing.");
+
+ public:
+  using value_type = T;
+
+  template <typename... Args, typename = std::enable_if_t<std::is_constructible<T, Args...>::value>>
+  explicit ref_source(std::in_place_t, Args &&...args) : m_value(std::forward<Args>(args)...) {}
+
+  ref_source(T const &value) : m_value{value} {}
+  ref_source(T &&value) : m_value{std::move(value)} {}
+
+  // A copy has borrowers of its own.
+  ref_source(ref_source const &other) : m_value{other.m_value} {}
+  ref_source(ref_source &&other) : m_value{detached(other)} {}
+
+  ref_source &operator=(ref_source const &other) {
+    if (this != &other) {
+      modify() = other.m_value;
+    }
+    return *this;
+  }
+
+  ref_source &operator=(ref_source &&other) {
+    if (this != &other) {
+      modify() = detached(other);
+    }
+    return *this;
+  }
+
+  ~ref_source() {
+    auto const lock = detail::lock_ref_source<Threading>(this);
+    if (m_borrowers != nullptr) {
+      if constexpr (std::is_nothrow_move_constructible<T>::value) {
+        m_snapshot->emplace(std::move(m_value));
+      } else {
+        m_snapshot->emplace(m_value);
+      }
+      hand_out_snapshot();
+    }
+  }
+
+  T const &operator*() const noexcept { return m_value; }
+  T const *operator->() const noexcept { return &m_value; }
+
+  // The value for modification, after the current borrowers got their snapshot.
+  T &modify() {
+    detach_borrowers();
+    return m_value;
+  }
+
+  // Number of deferred_refs still referring to the value.
+  std::size_t borrower_count() const {
+    auto const lock = detail::lock_ref_source<Threading>(this);
+    std::size_t count{0};
+    for (auto const *borrower = m_borrowers; borrower != nullptr; borrower = borrower->m_next) {
+      ++count;
+    }
+    return count;
+  }
+
+ private:
+  friend class deferred_ref<T const &, Threading>;
+  using borrower_type = deferred_ref<T const &, Threading>;
+
+  static T &&detached(ref_source &other) {
+    other.detach_borrowers();
+    return std::move(other.m_value);
+  }
+
+  // Hands all borrowers a single snapshot. If the copy throws, they keep
+  // borrowing the value.
+  void detach_borrowers() {
+    auto const lock = detail::lock_ref_source<Threading>(this);
+    if (m_borrowers != nullptr) {
+      m_snapshot->emplace(m_value);
+      hand_out_snapshot();
+    }
+  }
+
+  // Called with the lock held, once the snapshot holds the value.
+  void hand_out_snapshot() noexcept {
+    std::shared_ptr<T const> const snapshot{m_snapshot, &**m_snapshot};
+    m_snapshot.reset();
+    for (auto *borrower = m_borrowers; borrower != nullptr;) {
+      auto *const next = borrower->m_next;
+      borrower->m_snapshot = snapshot;
+      detail::store_slot(borrower->m_ref, snapshot.get());
+      borrower->m_previous = nullptr;
+      borrower->m_next = nullptr;
+      detail::store_slot(borrower->m_source, static_cast<ref_source const *>(nullptr));
+      borrower = next;
+    }
+    m_borrowers = nullptr;
+  }
+
+  // Both called with the lock of this source held. The first borrower
+  // allocates the storage of the snapshot.
+  void link(borrower_type &borrower) const {
+    if (m_snapshot == nullptr) {
+      m_snapshot = std::make_shared<std::optional<T>>();
+      detail::record_safe_ref_allocation<T>(sizeof(T));
+    }
+    borrower.m_previous = nullptr;
+    borrower.m_next = m_borrowers;
+    if (m_borrowers != nullptr) {
+      m_borrowers->m_previous = &borrower;
+    }
+    m_borrowers = &borrower;
+    detail::store_slot(borrower.m_ref, &m_value);
+    detail::store_slot(borrower.m_source, this);
+  }
+
+  void unlink(borrower_type &borrower) const noexcept {
+    if (borrower.m_previous != nullptr) {
+      borrower.m_previous->m_next = borrower.m_next;
+    } else {
+      m_borrowers = borrower.m_next;
+    }
+    if (borrower.m_next != nullptr) {
+      borrower.m_next->m_previous = borrower.m_previous;
+    }
+    borrower.m_previous = nullptr;
+    borrower.m_next = nullptr;
+    detail::store_slot(borrower.m_source, static_cast<ref_source const *>(nullptr));
+  }
+
+  T m_value;
+  mutable borrower_type *m_borrowers{nullptr};
+  mutable std::shared_ptr<std::optional<T>> m_snapshot{};
+};
+
+// A safe_ref to the value of a ref_source that copies nothing while the source
+// lives. Copies of a deferred_ref borrow from the same source, or share its
+// snapshot once the source handed one out.
+template <typename T, ref_threading Threading>
+class deferred_ref {
+  static_assert(std::is_lvalue_reference<T>::value &&
+                    std::is_const<std::remove_reference_t<T>>::value,
+                "Template argument T must be a const reference type.");
+
+ public:
+  using value_type = std::decay_t<T>;
+  using reference_type = T;
+  using source_type = ref_source<value_type, Threading>;
+
+  deferred_ref(source_type const &source) {
+    auto const lock = detail::lock_ref_source<Threading>(&source);
+    source.link(*this);
+  }
+
+  deferred_ref(deferred_ref const &other) { borrow(other); }
+
+  deferred_ref &operator=(deferred_ref const &other) {
+    if (this != &other) {
+      release();
+      m_snapshot.reset();
+      borrow(other);
+    }
+    return *this;
+  }
+
+  ~deferred_ref() { release(); }
+
+  reference_type operator*() const noexcept {
+    detail::record_safe_ref_dereference<value_type>();
+    return *detail::load_slot(m_ref);
+  }
+
+  value_type const *operator->() const noexcept { return &**this; }
+
+  // Whether this still refers to the value of its source rather than a snapshot.
+  bool is_borrowed() const noexcept { return detail::load_slot(m_source) != nullptr; }
+
+  // Compared as safe_ref, by their referents.
+  auto operator==(deferred_ref const &other) const noexcept { return **this == *other; }
+  auto operator<(deferred_ref const &other) const noexcept { return **this < *other; }
+
+#if defined(__cpp_lib_three_way_comparison)
+  auto operator<=>(deferred_ref const &other) const noexcept
+    requires std::three_way_comparable<value_type>
+  {
+    return **this <=> *other;
+  }
+
+  template <typename U>
+  auto operator<=>(U const &other) const noexcept
+    requires detail::is_plain_operand<U> && std::three_way_comparable_with<value_type, U>
+  {
+    return **this <=> other;
+  }
+#endif
+
+ private:
+  friend source_type;
+
+  // The source of other is locked and checked again, as it may be detaching
+  // other meanwhile. Once detached, the snapshot of other is final.
+  void borrow(deferred_ref const &other) {
+    for (;;) {
+      auto const *const source = detail::load_slot(other.m_source);
+      if (source == nullptr) {
+        m_snapshot = other.m_snapshot;
+        detail::store_slot(m_ref, m_snapshot.get());
+        return;
+      }
+      auto const lock = detail::lock_ref_source<Threading>(source);
+      if (detail::load_slot(other.m_source) == source) {
+        source->link(*this);
+        return;
+      }
+    }
+  }
+
+  void release() noexcept {
+    for (;;) {
+      auto const *const source = detail::load_slot(m_source);
+      if (source == nullptr) {
+        return;
+      }
+      auto const lock = detail::lock_ref_source<Threading>(source);
+      if (detail::load_slot(m_source) == source) {
+        source->unlink(*this);
+        return;
+      }
+    }
+  }
+
+  detail::ref_slot<value_type const *, Threading> m_ref{nullptr};
+  detail::ref_slot<source_type const *, Threading> m_source{nullptr};
+  deferred_ref *m_previous{nullptr};
+  deferred_ref *m_next{nullptr};
+  std::shared_ptr<value_type const> m_snapshot{};
+};
+
+namespace detail {
+
+template <typename T, ref_threading Threading>
+struct is_ref_wrapper<deferred_ref<T, Threading>> : std::true_type {};
+
+}  // namespace detail
+
+// Any U comparable with the referent is compared with it directly, see
+// optional_ref.
+
+template <typename T, ref_threading Threading, typename U,
+          typename = detail::enable_if_ref_equality_comparable<T, U>>
+bool operator==(U const &lhs, deferred_ref<T, Threading> const &rhs) {
+  return (lhs == *rhs);
+}
+
+template <typename T, ref_threading Threading, typename U,
+          typename = detail::enable_if_ref_equality_comparable<T, U>>
+bool operator==(deferred_ref<T, Threading> const &lhs, U const &rhs) {
+  return (*lhs == rhs);
+}
+
+template <typename T, ref_threading Threading, typename U,
+          typename = detail::enable_if_ref_less_comparable<T, U>>
+bool operator<(U const &lhs, deferred_ref<T, Threading> const &rhs) {
+  return (lhs < *rhs);
+}
+
+template <typename T, ref_threading Threading, typename U,
+          typename = detail::enable_if_ref_less_comparable<T, U>>
+bool operator<(deferred_ref<T, Threading> const &lhs, U const &rhs) {
+  return (*lhs < rhs);
+}
+
+template <typename T, ref_threading Threading>
+bool operator!=(deferred_ref<T, Threading> const &lhs, deferred_ref<T, Threading> const &rhs) {
+  return !(*lhs == *rhs);
+}
+
+template <typename T, ref_threading Threading, typename U,
+          typename = detail::enable_if_ref_equality_comparable<T, U>>
+bool operator!=(U const &lhs, deferred_ref<T, Threading> const &rhs) {
+  return !(lhs == *rhs);
+}
+
+template <typename T, ref_threading Threading, typename U,
+          typename = detail::enable_if_ref_equality_comparable<T, U>>
+bool operator!=(deferred_ref<T, Threading> const &lhs, U const &rhs) {
+  return !(*lhs == rhs);
+}
+
+template <typename T, ref_threading Threading>
+bool operator<=(deferred_ref<T, Threading> const &lhs, deferred_ref<T, Threading> const &rhs) {
+  return !(*rhs < *lhs);
+}
+
+template <typename T, ref_threading Threading, typename U,
+          typename = detail::enable_if_ref_less_comparable<T, U>>
+bool operator<=(U const &lhs, deferred_ref<T, Threading> const &rhs) {
+  return !(*rhs < lhs);
+}
+
+template <typename T, ref_threading Threading, typename U,
+          typename = detail::enable_if_ref_less_comparable<T, U>>
+bool operator<=(deferred_ref<T, Threading> const &lhs, U const &rhs) {
+  return !(rhs < *lhs);
+}
+
+template <typename T, ref_threading Threading>
+bool operator>(deferred_ref<T, Threading> const &lhs, deferred_ref<T, Threading> const &rhs) {
+  return (*rhs < *lhs);
+}
+
+template <typename T, ref_threading Threading, typename U,
+          typename = detail::enable_if_ref_less_comparable<T, U>>
+bool operator>(U const &lhs, deferred_ref<T, Threading> const &rhs) {
+  return (*rhs < lhs);
+}
+
+template <typename T, ref_threading Threading, typename U,
+          typename = detail::enable_if_ref_less_comparable<T, U>>
+bool operator>(deferred_ref<T, Threading> const &lhs, U const &rhs) {
+  return (rhs < *lhs);
+}
+
+template <typename T, ref_threading Threading>
+bool operator>=(deferred_ref<T, Threading> const &lhs, deferred_ref<T, Threading> const &rhs) {
+  return !(*lhs < *rhs);
+}
+
+template <typename T, ref_threading Threading, typename U,
+          typename = detail::enable_if_ref_less_comparable<T, U>>
+bool operator>=(U const &lhs, deferred_ref<T, Threading> const &rhs) {
+  return !(lhs < *rhs);
+}
+
+template <typename T, ref_threading Threading, typename U,
+          typename = detail::enable_if_ref_less_comparable<T, U>>
+bool operator>=(deferred_ref<T, Threading> const &lhs, U const &rhs) {
+  return !(*lhs < rhs);
+}
+
+// A deferred_ref always has a value, so it is greater than an empty std::optional.
+
+template <typename T, ref_threading Threading, typename U,
+          typename = detail::enable_if_optional_equality_comparable<T, U>>
+bool operator==(deferred_ref<T, Threading> const &lhs, std::optional<U> const &rhs) {
+  return rhs.has_value() && (*lhs == *rhs);
+}
+
+template <typename T, ref_threading Threading, typename U,
+          typename = detail::enable_if_optional_equality_comparable<T, U>>
+bool operator==(std::optional<U> const &lhs, deferred_ref<T, Threading> const &rhs) {
+  return lhs.has_value() && (*lhs == *rhs);
+}
+
+template <typename T, ref_threading Threading, typename U,
+          typename = detail::enable_if_optional_equality_comparable<T, U>>
+bool operator!=(deferred_ref<T, Threading> const &lhs, std::optional<U> const &rhs) {
+  return !(lhs == rhs);
+}
+
+template <typename T, ref_threading Threading, typename U,
+          typename = detail::enable_if_optional_equality_comparable<T, U>>
+bool operator!=(std::optional<U> const &lhs, deferred_ref<T, Threading> const &rhs) {
+  return !(lhs == rhs);
+}
+
+template <typename T, ref_threading Threading, typename U,
+          typename = detail::enable_if_optional_ordered<T, U>>
+bool operator<(deferred_ref<T, Threading> const &lhs, std::optional<U> const &rhs) {
+  return rhs.has_value() && (*lhs < *rhs);
+}
+
+template <typename T, ref_threading Threading, typename U,
+          typename = detail::enable_if_optional_ordered<T, U>>
+bool operator<(std::optional<U> const &lhs, deferred_ref<T, Threading> const &rhs) {
+  return !lhs.has_value() || (*lhs < *rhs);
+}
+
+template <typename T, ref_threading Threading, typename U,
+          typename = detail::enable_if_optional_ordered<T, U>>
+bool operator<=(deferred_ref<T, Threading> const &lhs, std::optional<U> const &rhs) {
+  return !(rhs < lhs);
+}
+
+template <typename T, ref_threading Threading, typename U,
+          typename = detail::enable_if_optional_ordered<T, U>>
+bool operator<=(std::optional<U> const &lhs, deferred_ref<T, Threading> const &rhs) {
+  return !(rhs < lhs);
+}
+
+template <typename T, ref_threading Threading, typename U,
+          typename = detail::enable_if_optional_ordered<T, U>>
+bool operator>(deferred_ref<T, Threading> const &lhs, std::optional<U> const &rhs) {
+  return (rhs < lhs);
+}
+
+template <typename T, ref_threading Threading, typename U,
+          typename = detail::enable_if_optional_ordered<T, U>>
+bool operator>(std::optional<U> const &lhs, deferred_ref<T, Threading> const &rhs) {
+  return (rhs < lhs);
+}
+
+template <typename T, ref_threading Threading, typename U,
+          typename = detail::enable_if_optional_ordered<T, U>>
+bool operator>=(deferred_ref<T, Threading> const &lhs, std::optional<U> const &rhs) {
+  return !(lhs < rhs);
+}
+
+template <typename T, ref_threading Threading, typename U,
+          typename = detail::enable_if_optional_ordered<T, U>>
+bool operator>=(std::optional<U> const &lhs, deferred_ref<T, Threading> const &rhs) {
+  return !(lhs < rhs);
+}
+
+}  // namespace me_std
+
+namespace std {
+
+template <typename T, me_std::ref_threading Threading>
+struct hash<me_std::deferred_ref<T, Threading>> {
+  std::size_t operator()(me_std::deferred_ref<T, Threading> const &ref) const
+      noexcept(noexcept(std::hash<std::decay_t<T>>{}(*ref))) {
+    return std::hash<std::decay_t<T>>{}(*ref);
+  }
+};
+
+}  // namespace std
+
+#endif  // ME_STD_DEFERRED_REF_HPP
@@ -0,0 +1,117 @@
+#ifndef ME_STD_FIND_REF_HPP
+#define ME_STD_FIND_REF_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <me_std/optional_ref.hpp>
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+namespace me_std {
+
+// Marks a range as sorted, so find_ref searches it by binary search.
+struct sorted_t {
+  explicit sorted_t() = default;
+};
+inline constexpr sorted_t sorted{};
+
+namespace detail {
+
+template <typename Container, typename = void>
+struct has_mapped_type : std::false_type {};
+
+template <typename Container>
+struct has_mapped_type<Container, std::void_t<typename Container::mapped_type>>
+    : std::true_type {};
+
+// The referent of an element reached through an iterator of Container: the
+// mapped value of a map, the element of anything else.
+template <typename Container, typename Iterator>
+constexpr decltype(auto) found_value(Iterator found) noexcept {
+  if constexpr (has_mapped_type<std::remove_const_t<Container>>::value) {
+    return (found->second);
+  } else {
+    return (*found);
+  }
+}
+
+template <typename Container>
+using found_ref = optional_ref<decltype(found_value<Container>(
+    std::declval<decltype(std::declval<Container &>().find(
+        std::declval<typename std::remove_const_t<Container>::key_type const &>()))>()))>;
+
+}  // namespace detail
+
+// Looks key up in a std::map, std::unordered_map, std::set or any container
+// with a find member. Maps refer to the mapped value, sets to the element.
+// Keys of another type than key_type are passed on as they are, so containers
+// with a transparent comparator or hash find them without a temporary key.
+template <typename Container, typename Key>
+constexpr auto find_ref(Container &container, Key const &key)
+    -> detail::found_ref<Container> {
+  auto const found = container.find(key);
+  if (found == container.end()) {
+    return {};
+  }
+  return detail::found_value<Container>(found);
+}
+
+// Looks key up in a sorted range by binary search. compare must be the order
+// the range is sorted by; std::less<> compares key with the elements as they
+// are.
+template <typename Range, typename Key, typename Compare = std::less<>>
+constexpr auto find_ref(sorted_t, Range &range, Key const &key, Compare compare = Compare{})
+    -> optional_ref<decltype(*std::begin(range))> {
+  auto const last = std::end(range);
+  auto const found = std::lower_bound(std::begin(range), last, key, compare);
+  if ((found == last) || compare(key, *found)) {
+    return {};
+  }
+  return *found;
+}
+
+// Refers to the pointee of a raw or smart pointer, nothing if it is null.
+template <typename T>
+constexpr optional_ref<T &> find_ref(T *pointer) noexcept {
+  if (pointer == nullptr) {
+    return {};
+  }
+  return *pointer;
+}
+
+template <typename T, typename Deleter>
+constexpr optional_ref<T &> find_ref(std::unique_ptr<T, Deleter> const &pointer) noexcept {
+  return find_ref(pointer.get());
+}
+
+template <typename T>
+optional_ref<T &> find_ref(std::shared_ptr<T> const &pointer) noexcept {
+  return find_ref(pointer.get());
+}
+
+// Refers to the element at index of a random access range, nothing if index
+// is out of range.
+template <typename Range,
+          typename = std::enable_if_t<!detail::has_mapped_type<std::remove_const_t<Range>>::value>>
+constexpr auto at_ref(Range &range, std::size_t index) noexcept
+    -> optional_ref<decltype(*std::begin(range))> {
+  if (index >= static_cast<std::size_t>(std::size(range))) {
+    return {};
+  }
+  return *(std::begin(range) + static_cast<std::ptrdiff_t>(index));
+}
+
+// Refers to the value mapped to key in a std::map, std::unordered_map or any
+// other container with a mapped_type, nothing where at() would throw.
+template <typename Map, typename Key,
+          typename = std::enable_if_t<detail::has_mapped_type<std::remove_const_t<Map>>::value>>
+constexpr auto at_ref(Map &map, Key const &key) -> detail::found_ref<Map> {
+  return find_ref(map, key);
+}
+
+}  // namespace me_std
+
+#endif  // ME_STD_FIND_REF_HPP
@@ -0,0 +1,337 @@
+#ifndef ME_STD_OPTIONAL_PROXY_REF_HPP
+#define ME_STD_OPTIONAL_PROXY_REF_HPP
+
+#include <cassert>
+#include <cstddef>
+#include <me_std/compare_traits.hpp>
+#include <memory>
+#include <optional>
+#include <type_traits>
+#include <utility>
+
+namespace me_std {
+
+// An accessor tells optional_proxy_ref how to reach an element that may have
+// no address of its own, such as a bit of a std::vector<bool>, an entry of a
+// column or a compressed field. It provides
+//
+//   reference       what dereferencing yields, a reference or a proxy object
+//   value_type      what the element holds
+//   locator_type    a trivially copyable value locating an element
+//   empty()         the locator of no element
+//   is_empty(l)     whether l is the locator of no element
+//   locate(args...) the locator of an element, from what identifies it
+//   access(l)       the element located by l, as a reference
+//
+// An empty locator needs no flag of its own, so an optional_proxy_ref is as
+// large as its locator.
+
+// Locates a referent by its address, the accessor of plain references.
+template <typename T>
+struct reference_accessor {
+  static_assert(std::is_lvalue_reference<T>::value == true,
+                "Template argument T must be a reference type.");
+
+  using reference = T;
+  using value_type = std::decay_t<T>;
+  using locator_type = std::remove_reference_t<T> *;
+
+  static constexpr locator_type empty() noexcept { return nullptr; }
+  static constexpr bool is_empty(locator_type locator) noexcept { return locator == nullptr; }
+  static constexpr locator_type locate(reference value) noexcept { return std::addressof(value); }
+  static constexpr reference access(locator_type locator) noexcept { return *locator; }
+};
+
+// Locates an element by its container and index, for containers whose
+// operator[] yields a proxy such as std::vector<bool> and std::bitset, or
+// columns of a structure of arrays.
+template <typename Container>
+struct indexed_accessor {
+  using reference = decltype(std::declval<Container &>()[std::size_t{}]);
+  using value_type = std::decay_t<decltype(std::declval<Container const &>()[std::size_t{}])>;
+
+  struct locator_type {
+    Container *container;
+    std::size_t index;
+  };
+
+  static constexpr locator_type empty() noexcept { return locator_type{nullptr, 0U}; }
+  static constexpr bool is_empty(locator_type locator) noexcept {
+    return locator.container == nullptr;
+  }
+  static constexpr locator_type locate(Container &container, std::size_t index) noexcept {
+    return locator_type{std::addressof(container), index};
+  }
+  static constexpr reference access(locator_type locator) {
+    return (*locator.container)[locator.index];
+  }
+};
+
+// optional_ref for elements reached through an accessor, see above. Compares
+// like optional_ref: an empty ref equals an empty ref and is less than every
+// value, otherwise the elements are compared.
+template <typename Accessor>
+class optional_proxy_ref {
+  static_assert(std::is_trivially_copyable<typename Accessor::locator_type>::value,
+                "The locator of an accessor must be trivially copyable.");
+
+ public:
+  using accessor_type = Accessor;
+  using reference_type = typename Accessor::reference;
+  using value_type = typename Accessor::value_type;
+  using locator_type = typename Accessor::locator_type;
+
+  constexpr optional_proxy_ref() noexcept = default;
+
+  // Refers to the element Accessor::locate(args...) locates.
+  template <typename... Args,
+            typename = decltype(Accessor::locate(std::declval<Args &&>()...))>
+  constexpr optional_proxy_ref(Args &&...args) noexcept(
+      noexcept(Accessor::locate(std::forward<Args>(args)...)))
+      : m_locator{Accessor::locate(std::forward<Args>(args)...)} {}
+
+  constexpr bool has_value() const noexcept { return !Accessor::is_empty(m_locator); }
+
+  constexpr reference_type operator*() const {
+    assert(has_value());
+    return Accessor::access(m_locator);
+  }
+
+  constexpr reference_type value() const {
+    if (!has_value()) {
+      throw std::bad_optional_access{};
+    }
+    return Accessor::access(m_locator);
+  }
+
+  constexpr value_type value_or(value_type default_value) const {
+    return has_value() ? value_type(**this) : std::move(default_value);
+  }
+
+  constexpr locator_type locator() const noexcept { return m_locator; }
+
+  constexpr operator std::optional<value_type>() const {
+    if (has_value()) {
+      return std::optional<value_type>{value_type(**this)};
+    }
+    return std::optional<value_type>{};
+  }
+
+ private:
+  locator_type m_locator{Accessor::empty()};
+};
+
+// A plain reference costs what optional_ref does, a pointer.
+static_assert(sizeof(optional_proxy_ref<reference_accessor<int &>>) == sizeof(int *));
+static_assert(std::is_trivially_copyable<optional_proxy_ref<reference_accessor<int &>>>::value);
+
+// The element of a Container at an index.
+template <typename Container>
+using optional_element_ref = optional_proxy_ref<indexed_accessor<Container>>;
+
+namespace detail {
+
+template <typename A>
+struct is_ref_wrapper<optional_proxy_ref<A>> : std::true_type {};
+
+// The element as it compares: a reference as it is, a proxy as its value.
+template <typename A>
+constexpr decltype(auto) compared(optional_proxy_ref<A> const &ref) {
+  if constexpr (std::is_reference<typename A::reference>::value) {
+    return *ref;
+  } else {
+    return static_cast<typename A::value_type>(*ref);
+  }
+}
+
+}  // namespace detail
+
+template <typename A>
+constexpr bool operator==(optional_proxy_ref<A> const &lhs, optional_proxy_ref<A> const &rhs) {
+  if (lhs.has_value() != rhs.has_value()) {
+    return false;
+  }
+  return !lhs.has_value() || (detail::compared(lhs) == detail::compared(rhs));
+}
+
+template <typename A>
+constexpr bool operator<(optional_proxy_ref<A> const &lhs, optional_proxy_ref<A> const &rhs) {
+  if (!rhs.has_value()) {
+    return false;
+  }
+  return !lhs.has_value() || (detail::compared(lhs) < detail::compared(rhs));
+}
+
+template <typename A>
+constexpr bool operator!=(optional_proxy_ref<A> const &lhs, optional_proxy_ref<A> const &rhs) {
+  return !(lhs == rhs);
+}
+
+template <typename A>
+constexpr bool operator<=(optional_proxy_ref<A> const &lhs, optional_proxy_ref<A> const &rhs) {
+  return !(rhs < lhs);
+}
+
+template <typename A>
+constexpr bool operator>(optional_proxy_ref<A> const &lhs, optional_proxy_ref<A> const &rhs) {
+  return rhs < lhs;
+}
+
+template <typename A>
+constexpr bool operator>=(optional_proxy_ref<A> const &lhs, optional_proxy_ref<A> const &rhs) {
+  return !(lhs < rhs);
+}
+
+// Any U comparable with the element is compared with it directly, see
+// optional_ref.
+
+template <typename A, typename U,
+          typename = detail::enable_if_ref_equality_comparable<typename A::value_type, U>>
+constexpr bool operator==(optional_proxy_ref<A> const &lhs, U const &rhs) {
+  return lhs.has_value() && (detail::compared(lhs) == rhs);
+}
+
+template <typename A, typename U,
+          typename = detail::enable_if_ref_equality_comparable<typename A::value_type, U>>
+constexpr bool operator==(U const &lhs, optional_proxy_ref<A> const &rhs) {
+  return rhs == lhs;
+}
+
+template <typename A, typename U,
+          typename = detail::enable_if_ref_equality_comparable<typename A::value_type, U>>
+constexpr bool operator!=(optional_proxy_ref<A> const &lhs, U const &rhs) {
+  return !(lhs == rhs);
+}
+
+template <typename A, typename U,
+          typename = detail::enable_if_ref_equality_comparable<typename A::value_type, U>>
+constexpr bool operator!=(U const &lhs, optional_proxy_ref<A> const &rhs) {
+  return !(rhs == lhs);
+}
+
+template <typename A, typename U,
+          typename = detail::enable_if_ref_less_comparable<typename A::value_type, U>>
+constexpr bool operator<(optional_proxy_ref<A> const &lhs, U const &rhs) {
+  return !lhs.has_value() || (detail::compared(lhs) < rhs);
+}
+
+template <typename A, typename U,
+          typename = detail::enable_if_ref_less_comparable<typename A::value_type, U>>
+constexpr bool operator<(U const &lhs, optional_proxy_ref<A> const &rhs) {
+  return rhs.has_value() && (lhs < detail::compared(rhs));
+}
+
+template <typename A, typename U,
+          typename = detail::enable_if_ref_ordered<typename A::value_type, U>>
+constexpr bool operator<=(optional_proxy_ref<A> const &lhs, U const &rhs) {
+  return (lhs == rhs) || (lhs < rhs);
+}
+
+template <typename A, typename U,
+          typename = detail::enable_if_ref_ordered<typename A::value_type, U>>
+constexpr bool operator<=(U const &lhs, optional_proxy_ref<A> const &rhs) {
+  return (lhs == rhs) || (lhs < rhs);
+}
+
+template <typename A, typename U,
+          typename = detail::enable_if_ref_ordered<typename A::value_type, U>>
+constexpr bool operator>(optional_proxy_ref<A> const &lhs, U const &rhs) {
+  return !(lhs <= rhs);
+}
+
+template <typename A, typename U,
+          typename = detail::enable_if_ref_ordered<typename A::value_type, U>>
+constexpr bool operator>(U const &lhs, optional_proxy_ref<A> const &rhs) {
+  return !(lhs <= rhs);
+}
+
+template <typename A, typename U,
+          typename = detail::enable_if_ref_ordered<typename A::value_type, U>>
+constexpr bool operator>=(optional_proxy_ref<A> const &lhs, U const &rhs) {
+  return !(lhs < rhs);
+}
+
+template <typename A, typename U,
+          typename = detail::enable_if_ref_ordered<typename A::value_type, U>>
+constexpr bool operator>=(U const &lhs, optional_proxy_ref<A> const &rhs) {
+  return !(lhs < rhs);
+}
+
+// A std::optional is compared by its value, empty as with std::optional.
+
+template <typename A, typename U,
+          typename = detail::enable_if_optional_equality_comparable<typename A::value_type, U>>
+constexpr bool operator==(optional_proxy_ref<A> const &lhs, std::optional<U> const &rhs) {
+  return (lhs.has_value() == rhs.has_value()) &&
+         (!lhs.has_value() || (detail::compared(lhs) == *rhs));
+}
+
+template <typename A, typename U,
+          typename = detail::enable_if_optional_equality_comparable<typename A::value_type, U>>
+constexpr bool operator==(std::optional<U> const &lhs, optional_proxy_ref<A> const &rhs) {
+  return rhs == lhs;
+}
+
+template <typename A, typename U,
+          typename = detail::enable_if_optional_equality_comparable<typename A::value_type, U>>
+constexpr bool operator!=(optional_proxy_ref<A> const &lhs, std::optional<U> const &rhs) {
+  return !(lhs == rhs);
+}
+
+template <typename A, typename U,
+          typename = detail::enable_if_optional_equality_comparable<typename A::value_type, U>>
+constexpr bool operator!=(std::optional<U> const &lhs, optional_proxy_ref<A> const &rhs) {
+  return !(rhs == lhs);
+}
+
+template <typename A, typename U,
+          typename = detail::enable_if_optional_ordered<typename A::value_type, U>>
+constexpr bool operator<(optional_proxy_ref<A> const &lhs, std::optional<U> const &rhs) {
+  return rhs.has_value() && (!lhs.has_value() || (detail::compared(lhs) < *rhs));
+}
+
+template <typename A, typename U,
+          typename = detail::enable_if_optional_ordered<typename A::value_type, U>>
+constexpr bool operator<(std::optional<U> const &lhs, optional_proxy_ref<A> const &rhs) {
+  return rhs.has_value() && (!lhs.has_value() || (*lhs < detail::compared(rhs)));
+}
+
+template <typename A, typename U,
+          typename = detail::enable_if_optional_ordered<typename A::value_type, U>>
+constexpr bool operator<=(optional_proxy_ref<A> const &lhs, std::optional<U> const &rhs) {
+  return !(rhs < lhs);
+}
+
+template <typename A, typename U,
+          typename = detail::enable_if_optional_ordered<typename A::value_type, U>>
+constexpr bool operator<=(std::optional<U> const &lhs, optional_proxy_ref<A> const &rhs) {
+  return !(rhs < lhs);
+}
+
+template <typename A, typename U,
+          typename = detail::enable_if_optional_ordered<typename A::value_type, U>>
+constexpr bool operator>(optional_proxy_ref<A> const &lhs, std::optional<U> const &rhs) {
+  return rhs < lhs;
+}
+
+template <typename A, typename U,
+          typename = detail::enable_if_optional_ordered<typename A::value_type, U>>
+constexpr bool operator>(std::optional<U> const &lhs, optional_proxy_ref<A> const &rhs) {
+  return rhs < lhs;
+}
+
+template <typename A, typename U,
+          typename = detail::enable_if_optional_ordered<typename A::value_type, U>>
+constexpr bool operator>=(optional_proxy_ref<A> const &lhs, std::optional<U> const &rhs) {
+  return !(lhs < rhs);
+}
+
+template <typename A, typename U,
+          typename = detail::enable_if_optional_ordered<typename A::value_type, U>>
+constexpr bool operator>=(std::optional<U> const &lhs, optional_proxy_ref<A> const &rhs) {
+  return !(lhs < rhs);
+}
+
+}  // namespace me_std
+
+#endif  // ME_STD_OPTIONAL_PROXY_REF_HPP
@@ -2,11 +2,99 @@
 #define ME_STD_OPTIONAL_REF_HPP
 
 #include <cassert>
+#include <cstddef>
+#include <functional>
+#include <me_std/compare_traits.hpp>
+#include <me_std/ref_lifetime.hpp>
 #include <optional>
 #include <type_traits>
+#include <utility>
 
 namespace me_std {
 
+template <typename T>
+class optional_ref;
+
+namespace detail {
+
+template <typename T>
+struct type_identity {
+  using type = T;
+};
+
+template <typename T>
+using type_identity_t = typename type_identity<T>::type;
+
+// Referents an optional_ref may hand out copies of. A copy of a polymorphic
+// referent has its static type, as with any copy of a base.
+template <typename V>
+using is_copyable_referent =
+    std::bool_constant<std::is_copy_constructible<V>::value && !std::is_abstract<V>::value>;
+
+template <typename V>
+using enable_if_copyable_referent = std::enable_if_t<is_copyable_referent<V>::value>;
+
+// std::invoke with a single argument, usable in constant expressions before C++20.
+template <typename F, typename Arg>
+constexpr decltype(auto) invoke(F &&function, Arg &&arg) {
+  if constexpr (std::is_member_function_pointer<std::decay_t<F>>::value) {
+    return (std::forward<Arg>(arg).*function)();
+  } else if constexpr (std::is_member_object_pointer<std::decay_t<F>>::value) {
+    return (std::forward<Arg>(arg).*function);
+  } else {
+    return std::forward<F>(function)(std::forward<Arg>(arg));
+  }
+}
+
+// A reference is referred to, anything else is held by value.
+template <typename R>
+using transform_result_t =
+    std::conditional_t<std::is_lvalue_reference<R>::value, optional_ref<R>,
+                       std::optional<std::remove_cv_t<std::remove_reference_t<R>>>>;
+
+// A std::optional returned by reference is referred into, not copied.
+template <typename R>
+struct and_then_result {
+  using type = std::remove_cv_t<std::remove_reference_t<R>>;
+  static constexpr bool borrowed = false;
+};
+
+template <typename V>
+struct and_then_result<std::optional<V> &> {
+  using type = optional_ref<V &>;
+  static constexpr bool borrowed = true;
+};
+
+template <typename V>
+struct and_then_result<std::optional<V> const &> {
+  using type = optional_ref<V const &>;
+  static constexpr bool borrowed = true;
+};
+
+template <typename T>
+struct is_optional_ref : std::false_type {};
+
+template <typename T>
+struct is_optional_ref<optional_ref<T>> : std::true_type {};
+
+// What or_else may refer to: an optional_ref, or anything returned by lvalue
+// reference. A std::optional or value returned by value is gone after the call.
+template <typename R, typename T>
+using enable_if_or_else_result = std::enable_if_t<
+    (std::is_lvalue_reference<R>::value ||
+     is_optional_ref<std::remove_cv_t<std::remove_reference_t<R>>>::value) &&
+    std::is_convertible<R, optional_ref<T>>::value>;
+
+// Refers to a default returned by reference, copies the referent otherwise.
+template <typename T, typename R>
+using value_or_else_result_t =
+    std::conditional_t<std::is_lvalue_reference<R>::value &&
+                           std::is_convertible<std::remove_reference_t<R> *,
+                                               std::remove_reference_t<T> *>::value,
+                       T, std::decay_t<T>>;
+
+}  // namespace detail
+
 template <typename T>
 class optional_ref {
   static_assert(std::is_lvalue_reference<T>::value == true,
@@ -15,55 +103,142 @@ class optional_ref {
  public:
   using value_type = std::decay_t<T>;
   using reference_type = T;
+  using pointer_type = std::remove_reference_t<T> *;
+
+  constexpr optional_ref() noexcept = default;
+  constexpr optional_ref(std::nullopt_t) noexcept {}
+  constexpr optional_ref(reference_type value) noexcept : m_value{&value} { track(); }
+
+  // Templates, so overload resolution never instantiates std::optional<value_type>,
+  // which is ill-formed for abstract types.
+  template <typename V, typename = std::enable_if_t<std::is_same<V, value_type>::value>>
+  constexpr optional_ref(std::optional<V> const &optional) noexcept
+      : m_value{optional.has_value() ? optional.operator->() : nullptr} {
+    track();
+  }
 
-  optional_ref() = default;
-  optional_ref(reference_type value) : m_value{&value} {}
-
-  optional_ref(std::optional<value_type> const &optional)
-      : m_value{optional.has_value() ? optional.operator->() : nullptr} {}
-
-  optional_ref(std::optional<value_type> &optional)
-      : m_value{optional.has_value() ? optional.operator->() : nullptr} {}
+  template <typename V, typename = std::enable_if_t<std::is_same<V, value_type>::value>>
+  constexpr optional_ref(std::optional<V> &optional) noexcept
+      : m_value{optional.has_value() ? optional.operator->() : nullptr} {
+    track();
+  }
 
-  auto has_value() const noexcept { return m_value != nullptr; }
+  constexpr auto has_value() const noexcept { return m_value != nullptr; }
 
-  auto operator*() const noexcept {
+  constexpr reference_type operator*() const noexcept {
     assert(has_value());
+    check();
     return *m_value;
   }
 
-  auto operator->() const noexcept {
+  constexpr pointer_type operator->() const noexcept {
     assert(has_value());
+    check();
     return m_value;
   }
 
-  auto value() const {
+  constexpr reference_type value() const {
     if (!has_value()) {
       throw std::bad_optional_access{};
     }
+    check();
     return *m_value;
   }
 
-  operator std::optional<value_type>() const noexcept {
+  // Refers to either the referent or default_value, nothing is copied.
+  constexpr reference_type value_or(reference_type default_value) const noexcept {
+    return has_value() ? **this : default_value;
+  }
+
+  // A temporary default_value can not be referred to, so the result is a value.
+  // Only for copyable referents of a type that is not abstract.
+  template <typename V = value_type, typename = detail::enable_if_copyable_referent<V>>
+  constexpr V value_or(detail::type_identity_t<V> &&default_value) const {
+    return has_value() ? V{**this} : std::move(default_value);
+  }
+
+  // Other referents can not be copied out, and a reference to a temporary
+  // default_value would dangle.
+  template <typename V = value_type,
+            typename = std::enable_if_t<!detail::is_copyable_referent<V>::value>>
+  void value_or(std::remove_reference_t<T> &&default_value) const = delete;
+
+  template <typename V = value_type, typename = detail::enable_if_copyable_referent<V>,
+            typename = std::enable_if_t<std::is_same<V, value_type>::value>>
+  constexpr operator std::optional<V>() const
+      noexcept(std::is_nothrow_copy_constructible<V>::value) {
     if (has_value()) {
-      return std::optional<value_type>{value()};
+      return std::optional<V>{value()};
+    }
+    return std::optional<V>{};
+  }
+
+  // The referent passed to function, or empty without calling it. The result
+  // refers to what function returns by reference and holds anything else, so
+  // projections such as transform(&config::name) copy nothing.
+  template <typename F, typename R = std::invoke_result_t<F, reference_type>>
+  constexpr detail::transform_result_t<R> transform(F &&function) const {
+    static_assert(!std::is_void<R>::value, "The function must return a value.");
+    if (!has_value()) {
+      return detail::transform_result_t<R>{};
+    }
+    return detail::transform_result_t<R>{detail::invoke(std::forward<F>(function), **this)};
+  }
+
+  // As transform, for a function returning an optional_ref or std::optional,
+  // which is returned as it is. A std::optional returned by reference is
+  // referred to, so chains over optional members copy nothing either.
+  template <typename F, typename R = std::invoke_result_t<F, reference_type>>
+  constexpr typename detail::and_then_result<R>::type and_then(F &&function) const {
+    using result = typename detail::and_then_result<R>::type;
+    static_assert(detail::is_optional_ref<result>::value || detail::is_std_optional<result>::value,
+                  "The function must return an optional_ref or a std::optional.");
+    if (!has_value()) {
+      return result{};
+    }
+    if constexpr (detail::and_then_result<R>::borrowed) {
+      auto &optional = detail::invoke(std::forward<F>(function), **this);
+      return optional.has_value() ? result{*optional} : result{};
+    } else {
+      return detail::invoke(std::forward<F>(function), **this);
     }
-    return std::optional<value_type>{};
   }
 
-  auto operator==(optional_ref<reference_type> other) const noexcept {
+  // This if it has a value, else what function returns. function returns an
+  // optional_ref or an lvalue reference to a referent or std::optional.
+  template <typename F, typename R = std::invoke_result_t<F>,
+            typename = detail::enable_if_or_else_result<R, reference_type>>
+  constexpr optional_ref or_else(F &&function) const {
+    return has_value() ? *this : optional_ref{std::forward<F>(function)()};
+  }
+
+  // value_or with a default computed only when needed. A default returned by
+  // reference is referred to, anything else gives a copy.
+  template <typename F, typename R = std::invoke_result_t<F>>
+  constexpr detail::value_or_else_result_t<reference_type, R> value_or_else(F &&function) const {
+    using result = detail::value_or_else_result_t<reference_type, R>;
+    if constexpr (std::is_reference<result>::value) {
+      return has_value() ? **this : std::forward<F>(function)();
+    } else {
+      static_assert(detail::is_copyable_referent<result>::value,
+                    "A copy of the referent would be returned.");
+      return has_value() ? result{**this} : result{std::forward<F>(function)()};
+    }
+  }
+
+  constexpr auto operator==(optional_ref<reference_type> other) const noexcept {
     if (m_value == other.m_value) {
       return true;
     }
 
     if ((m_value != nullptr) && (other.m_value != nullptr)) {
-      return *m_value == *other.m_value;
+      return **this == *other;
     }
 
     return false;
   }
 
-  auto operator<(optional_ref<reference_type> other) const noexcept {
+  constexpr auto operator<(optional_ref<reference_type> other) const noexcept {
     if (m_value == other.m_value) {
       return false;
     }
@@ -76,143 +251,215 @@ class optional_ref {
       return false;
     }
 
-    return *m_value < *other.m_value;
+    return **this < *other;
   }
 
  private:
-  std::remove_reference_t<T> *m_value{nullptr};
+  // Binds to the generation of a registered referent, see ref_lifetime.
+  constexpr void track() noexcept {
+#if defined(ME_STD_CHECKED_REFS)
+    if (!detail::is_constant_evaluated() && (m_value != nullptr)) {
+      m_generation = detail::ref_registry::instance().find(m_value);
+    }
+#endif
+  }
+
+  constexpr void check() const noexcept {
+#if defined(ME_STD_CHECKED_REFS)
+    if (!detail::is_constant_evaluated() && (m_generation != 0U) &&
+        !detail::ref_registry::instance().is_alive(m_value, m_generation)) {
+      detail::report_dangling(m_value);
+    }
+#endif
+  }
+
+  pointer_type m_value{nullptr};
+#if defined(ME_STD_CHECKED_REFS)
+  detail::ref_generation m_generation{0};
+#endif
 };  // namespace me_std
 
-template <typename T>
-bool operator==(T const &lhs, optional_ref<T &> rhs) {
-  return rhs.has_value() && (lhs == *rhs);
-}
+#if !defined(ME_STD_CHECKED_REFS)
+// Unchecked, an optional_ref is exactly the pointer it holds.
+static_assert(sizeof(optional_ref<int &>) == sizeof(int *));
+static_assert(alignof(optional_ref<int &>) == alignof(int *));
+static_assert(std::is_trivially_copyable<optional_ref<int const &>>::value);
+static_assert(std::is_standard_layout<optional_ref<int const &>>::value);
+static_assert(std::is_empty<ref_lifetime>::value);
+#endif
 
-template <typename T>
-bool operator==(T const &lhs, optional_ref<T const &> rhs) {
-  return rhs.has_value() && (lhs == *rhs);
-}
+namespace detail {
 
 template <typename T>
-bool operator==(optional_ref<T &> lhs, T const &rhs) {
-  return lhs.has_value() && (*lhs == rhs);
+struct is_ref_wrapper<optional_ref<T>> : std::true_type {};
+
+}  // namespace detail
+
+// Any U comparable with the referent, such as a std::string_view or a string
+// literal for an optional_ref to a std::string, is compared with it directly.
+// An empty optional_ref is less than every value.
+
+template <typename T, typename U, typename = detail::enable_if_ref_equality_comparable<T, U>>
+constexpr bool operator==(U const &lhs, optional_ref<T> rhs) {
+  return rhs.has_value() && (lhs == *rhs);
 }
 
-template <typename T>
-bool operator==(optional_ref<T const &> lhs, T const &rhs) {
+template <typename T, typename U, typename = detail::enable_if_ref_equality_comparable<T, U>>
+constexpr bool operator==(optional_ref<T> lhs, U const &rhs) {
   return lhs.has_value() && (*lhs == rhs);
 }
 
-template <typename T>
-bool operator<(T const &lhs, optional_ref<T &> rhs) {
-  return rhs.has_value() && (lhs < *rhs);
-}
-template <typename T>
-bool operator<(T const &lhs, optional_ref<T const &> rhs) {
+template <typename T, typename U, typename = detail::enable_if_ref_less_comparable<T, U>>
+constexpr bool operator<(U const &lhs, optional_ref<T> rhs) {
   return rhs.has_value() && (lhs < *rhs);
 }
 
-template <typename T>
-bool operator<(optional_ref<T &> lhs, T const &rhs) {
-  return !lhs.has_value() || (*lhs < rhs);
-}
-template <typename T>
-bool operator<(optional_ref<T const &> lhs, T const &rhs) {
+template <typename T, typename U, typename = detail::enable_if_ref_less_comparable<T, U>>
+constexpr bool operator<(optional_ref<T> lhs, U const &rhs) {
   return !lhs.has_value() || (*lhs < rhs);
 }
 
 template <typename T>
-bool operator!=(optional_ref<T> lhs, optional_ref<T> rhs) {
+constexpr bool operator!=(optional_ref<T> lhs, optional_ref<T> rhs) {
   return !(lhs == rhs);
 }
 
-template <typename T>
-bool operator!=(T const &lhs, optional_ref<T &> rhs) {
-  return !(lhs == rhs);
-}
-template <typename T>
-bool operator!=(T const &lhs, optional_ref<T const &> rhs) {
+template <typename T, typename U, typename = detail::enable_if_ref_equality_comparable<T, U>>
+constexpr bool operator!=(U const &lhs, optional_ref<T> rhs) {
   return !(lhs == rhs);
 }
 
-template <typename T>
-bool operator!=(optional_ref<T &> lhs, T const &rhs) {
-  return !(lhs == rhs);
-}
-template <typename T>
-bool operator!=(optional_ref<T const &> lhs, T const &rhs) {
+template <typename T, typename U, typename = detail::enable_if_ref_equality_comparable<T, U>>
+constexpr bool operator!=(optional_ref<T> lhs, U const &rhs) {
   return !(lhs == rhs);
 }
 
 template <typename T>
-bool operator<=(optional_ref<T> lhs, optional_ref<T> rhs) {
+constexpr bool operator<=(optional_ref<T> lhs, optional_ref<T> rhs) {
   return (lhs == rhs) || (lhs < rhs);
 }
 
-template <typename T>
-bool operator<=(T const &lhs, optional_ref<T &> rhs) {
-  return (lhs == rhs) || (lhs < rhs);
-}
-template <typename T>
-bool operator<=(T const &lhs, optional_ref<T const &> rhs) {
+template <typename T, typename U, typename = detail::enable_if_ref_ordered<T, U>>
+constexpr bool operator<=(U const &lhs, optional_ref<T> rhs) {
   return (lhs == rhs) || (lhs < rhs);
 }
 
-template <typename T>
-bool operator<=(optional_ref<T &> lhs, T const &rhs) {
-  return (lhs == rhs) || (lhs < rhs);
-}
-template <typename T>
-bool operator<=(optional_ref<T const &> lhs, T const &rhs) {
+template <typename T, typename U, typename = detail::enable_if_ref_ordered<T, U>>
+constexpr bool operator<=(optional_ref<T> lhs, U const &rhs) {
   return (lhs == rhs) || (lhs < rhs);
 }
 
 template <typename T>
-bool operator>(optional_ref<T> lhs, optional_ref<T> rhs) {
+constexpr bool operator>(optional_ref<T> lhs, optional_ref<T> rhs) {
   return !(lhs <= rhs);
 }
 
-template <typename T>
-bool operator>(T const &lhs, optional_ref<T &> rhs) {
-  return !(lhs <= rhs);
-}
-template <typename T>
-bool operator>(T const &lhs, optional_ref<T const &> rhs) {
+template <typename T, typename U, typename = detail::enable_if_ref_ordered<T, U>>
+constexpr bool operator>(U const &lhs, optional_ref<T> rhs) {
   return !(lhs <= rhs);
 }
 
-template <typename T>
-bool operator>(optional_ref<T &> lhs, T const &rhs) {
-  return !(lhs <= rhs);
-}
-template <typename T>
-bool operator>(optional_ref<T const &> lhs, T const &rhs) {
+template <typename T, typename U, typename = detail::enable_if_ref_ordered<T, U>>
+constexpr bool operator>(optional_ref<T> lhs, U const &rhs) {
   return !(lhs <= rhs);
 }
 
 template <typename T>
-bool operator>=(optional_ref<T> lhs, optional_ref<T> rhs) {
+constexpr bool operator>=(optional_ref<T> lhs, optional_ref<T> rhs) {
   return (lhs == rhs) || (lhs > rhs);
 }
 
-template <typename T>
-bool operator>=(T const &lhs, optional_ref<T &> rhs) {
+template <typename T, typename U, typename = detail::enable_if_ref_ordered<T, U>>
+constexpr bool operator>=(U const &lhs, optional_ref<T> rhs) {
   return (lhs == rhs) || (lhs > rhs);
 }
-template <typename T>
-bool operator>=(T const &lhs, optional_ref<T const &> rhs) {
+
+template <typename T, typename U, typename = detail::enable_if_ref_ordered<T, U>>
+constexpr bool operator>=(optional_ref<T> lhs, U const &rhs) {
   return (lhs == rhs) || (lhs > rhs);
 }
 
-template <typename T>
-bool operator>=(optional_ref<T &> lhs, T const &rhs) {
-  return (lhs == rhs) || (lhs > rhs);
+// A std::optional is compared by its value, not converted. Empty compares
+// equal to empty and less than every value, as with std::optional.
+
+template <typename T, typename U, typename = detail::enable_if_optional_equality_comparable<T, U>>
+constexpr bool operator==(optional_ref<T> lhs, std::optional<U> const &rhs) {
+  return (lhs.has_value() == rhs.has_value()) && (!lhs.has_value() || (*lhs == *rhs));
 }
-template <typename T>
-bool operator>=(optional_ref<T const &> lhs, T const &rhs) {
-  return (lhs == rhs) || (lhs > rhs);
+
+template <typename T, typename U, typename = detail::enable_if_optional_equality_comparable<T, U>>
+constexpr bool operator==(std::optional<U> const &lhs, optional_ref<T> rhs) {
+  return (lhs.has_value() == rhs.has_value()) && (!lhs.has_value() || (*lhs == *rhs));
 }
 
+template <typename T, typename U, typename = detail::enable_if_optional_equality_comparable<T, U>>
+constexpr bool operator!=(optional_ref<T> lhs, std::optional<U> const &rhs) {
+  return !(lhs == rhs);
+}
+
+template <typename T, typename U, typename = detail::enable_if_optional_equality_comparable<T, U>>
+constexpr bool operator!=(std::optional<U> const &lhs, optional_ref<T> rhs) {
+  return !(lhs == rhs);
+}
+
+template <typename T, typename U, typename = detail::enable_if_optional_ordered<T, U>>
+constexpr bool operator<(optional_ref<T> lhs, std::optional<U> const &rhs) {
+  return rhs.has_value() && (!lhs.has_value() || (*lhs < *rhs));
+}
+
+template <typename T, typename U, typename = detail::enable_if_optional_ordered<T, U>>
+constexpr bool operator<(std::optional<U> const &lhs, optional_ref<T> rhs) {
+  return rhs.has_value() && (!lhs.has_value() || (*lhs < *rhs));
+}
+
+template <typename T, typename U, typename = detail::enable_if_optional_ordered<T, U>>
+constexpr bool operator<=(optional_ref<T> lhs, std::optional<U> const &rhs) {
+  return (lhs == rhs) || (lhs < rhs);
+}
+
+template <typename T, typename U, typename = detail::enable_if_optional_ordered<T, U>>
+constexpr bool operator<=(std::optional<U> const &lhs, optional_ref<T> rhs) {
+  return (lhs == rhs) || (lhs < rhs);
+}
+
+template <typename T, typename U, typename = detail::enable_if_optional_ordered<T, U>>
+constexpr bool operator>(optional_ref<T> lhs, std::optional<U> const &rhs) {
+  return !(lhs <= rhs);
+}
+
+template <typename T, typename U, typename = detail::enable_if_optional_ordered<T, U>>
+constexpr bool operator>(std::optional<U> const &lhs, optional_ref<T> rhs) {
+  return !(lhs <= rhs);
+}
+
+template <typename T, typename U, typename = detail::enable_if_optional_ordered<T, U>>
+constexpr bool operator>=(optional_ref<T> lhs, std::optional<U> const &rhs) {
+  return !(lhs < rhs);
+}
+
+template <typename T, typename U, typename = detail::enable_if_optional_ordered<T, U>>
+constexpr bool operator>=(std::optional<U> const &lhs, optional_ref<T> rhs) {
+  return !(lhs < rhs);
+}
+
+namespace detail {
+// Matches the hash libstdc++ uses for an empty std::optional.
+inline constexpr std::size_t optional_ref_empty_hash = static_cast<std::size_t>(-3333);
+}  // namespace detail
+
 }  // namespace me_std
 
+namespace std {
+
+template <typename T>
+struct hash<me_std::optional_ref<T>> {
+  std::size_t operator()(me_std::optional_ref<T> ref) const
+      noexcept(noexcept(std::hash<std::decay_t<T>>{}(*ref))) {
+    return ref.has_value() ? std::hash<std::decay_t<T>>{}(*ref)
+                           : me_std::detail::optional_ref_empty_hash;
+  }
+};
+
+}  // namespace std
+
 #endif  // ME_STD_OPTIONAL_REF_HPP
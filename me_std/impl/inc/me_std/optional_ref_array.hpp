@@ -0,0 +1,352 @@
+#ifndef ME_STD_OPTIONAL_REF_ARRAY_HPP
+#define ME_STD_OPTIONAL_REF_ARRAY_HPP
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <iterator>
+#include <me_std/optional_ref.hpp>
+#include <type_traits>
+#include <vector>
+#if __has_include(<bit>)
+#include <bit>
+#endif
+
+namespace me_std {
+
+namespace detail {
+
+inline int countr_zero(std::uint64_t word) noexcept {
+#if defined(__cpp_lib_bitops)
+  return std::countr_zero(word);
+#elif defined(__GNUC__)
+  return (word == 0U) ? 64 : __builtin_ctzll(word);
+#else
+  int zeros{0};
+  for (; (zeros < 64) && ((word & 1U) == 0U); ++zeros) {
+    word >>= 1U;
+  }
+  return zeros;
+#endif
+}
+
+inline int popcount(std::uint64_t word) noexcept {
+#if defined(__cpp_lib_bitops)
+  return std::popcount(word);
+#elif defined(__GNUC__)
+  return __builtin_popcountll(word);
+#else
+  int ones{0};
+  for (; word != 0U; word &= word - 1U) {
+    ++ones;
+  }
+  return ones;
+#endif
+}
+
+}  // namespace detail
+
+// Sequence of optional_ref<T> keeping the referent pointers contiguous and
+// their presence in a separate bitmap. Counting and finding present entries
+// work on 64 entries at a time.
+template <typename T>
+class optional_ref_array {
+  static_assert(std::is_lvalue_reference<T>::value == true,
+                "Template argument T must be a reference type.");
+
+ public:
+  using value_type = optional_ref<T>;
+  using reference_type = T;
+  using pointer_type = std::remove_reference_t<T> *;
+  using size_type = std::size_t;
+
+  // Random access iterator over all entries, yielding optional_ref<T> by value.
+  class const_iterator {
+   public:
+    using iterator_category = std::input_iterator_tag;
+#if defined(__cpp_lib_ranges)
+    using iterator_concept = std::random_access_iterator_tag;
+#endif
+    using value_type = optional_ref<T>;
+    using difference_type = std::ptrdiff_t;
+    using reference = value_type;
+    using pointer = void;
+
+    const_iterator() = default;
+
+    value_type operator*() const noexcept { return make_ref(*m_value); }
+    value_type operator[](difference_type offset) const noexcept {
+      return make_ref(m_value[offset]);
+    }
+
+    const_iterator &operator++() noexcept {
+      ++m_value;
+      return *this;
+    }
+    const_iterator operator++(int) noexcept { return const_iterator{m_value++}; }
+    const_iterator &operator--() noexcept {
+      --m_value;
+      return *this;
+    }
+    const_iterator operator--(int) noexcept { return const_iterator{m_value--}; }
+    const_iterator &operator+=(difference_type offset) noexcept {
+      m_value += offset;
+      return *this;
+    }
+    const_iterator &operator-=(difference_type offset) noexcept {
+      m_value -= offset;
+      return *this;
+    }
+
+    friend const_iterator operator+(const_iterator it, difference_type offset) noexcept {
+      return it += offset;
+    }
+    friend const_iterator operator+(difference_type offset, const_iterator it) noexcept {
+      return it += offset;
+    }
+    friend const_iterator operator-(const_iterator it, difference_type offset) noexcept {
+      return it -= offset;
+    }
+    friend difference_type operator-(const_iterator lhs, const_iterator rhs) noexcept {
+      return lhs.m_value - rhs.m_value;
+    }
+
+    friend bool operator==(const_iterator lhs, const_iterator rhs) noexcept {
+      return lhs.m_value == rhs.m_value;
+    }
+    friend bool operator!=(const_iterator lhs, const_iterator rhs) noexcept {
+      return lhs.m_value != rhs.m_value;
+    }
+    friend bool operator<(const_iterator lhs, const_iterator rhs) noexcept {
+      return lhs.m_value < rhs.m_value;
+    }
+    friend bool operator<=(const_iterator lhs, const_iterator rhs) noexcept {
+      return lhs.m_value <= rhs.m_value;
+    }
+    friend bool operator>(const_iterator lhs, const_iterator rhs) noexcept {
+      return lhs.m_value > rhs.m_value;
+    }
+    friend bool operator>=(const_iterator lhs, const_iterator rhs) noexcept {
+      return lhs.m_value >= rhs.m_value;
+    }
+
+   private:
+    friend class optional_ref_array;
+    explicit const_iterator(pointer_type const *value) noexcept : m_value{value} {}
+
+    pointer_type const *m_value{nullptr};
+  };
+
+  // Forward iterator over the present entries only. Skips empty entries a
+  // bitmap word at a time.
+  class present_iterator {
+   public:
+    using iterator_category = std::input_iterator_tag;
+#if defined(__cpp_lib_ranges)
+    using iterator_concept = std::forward_iterator_tag;
+#endif
+    using value_type = optional_ref<T>;
+    using difference_type = std::ptrdiff_t;
+    using reference = value_type;
+    using pointer = void;
+
+    present_iterator() = default;
+
+    value_type operator*() const noexcept { return value_type{*m_array->m_values[m_index]}; }
+
+    // Position of the current entry within the array.
+    size_type index() const noexcept { return m_index; }
+
+    present_iterator &operator++() noexcept {
+      if (m_bits != 0U) {
+        m_index = (m_index - (m_index % bits_per_word)) +
+                  static_cast<size_type>(detail::countr_zero(m_bits));
+        m_bits &= m_bits - 1U;
+      } else {
+        seek((m_index - (m_index % bits_per_word)) + bits_per_word);
+      }
+      return *this;
+    }
+    present_iterator operator++(int) noexcept {
+      auto const previous = *this;
+      ++*this;
+      return previous;
+    }
+
+    friend bool operator==(present_iterator lhs, present_iterator rhs) noexcept {
+      return lhs.m_index == rhs.m_index;
+    }
+    friend bool operator!=(present_iterator lhs, present_iterator rhs) noexcept {
+      return lhs.m_index != rhs.m_index;
+    }
+
+   private:
+    friend class optional_ref_array;
+    present_iterator(optional_ref_array const *array, size_type position) noexcept
+        : m_array{array} {
+      seek(position);
+    }
+
+    // Moves to the first present entry at or after position and keeps the
+    // presence bits following it within the same word.
+    void seek(size_type position) noexcept {
+      m_index = m_array->find_next(position);
+      m_bits = 0U;
+      if (m_index < m_array->size()) {
+        auto const offset = m_index % bits_per_word;
+        m_bits = m_array->m_present[m_index / bits_per_word] & (~std::uint64_t{1} << offset);
+      }
+    }
+
+    optional_ref_array const *m_array{nullptr};
+    size_type m_index{0};
+    std::uint64_t m_bits{0};
+  };
+
+  class present_range {
+   public:
+    present_iterator begin() const noexcept { return m_begin; }
+    present_iterator end() const noexcept { return m_end; }
+
+   private:
+    friend class optional_ref_array;
+    present_range(present_iterator begin, present_iterator end) noexcept
+        : m_begin{begin}, m_end{end} {}
+
+    present_iterator m_begin;
+    present_iterator m_end;
+  };
+
+  optional_ref_array() = default;
+  explicit optional_ref_array(size_type size) { resize(size); }
+  optional_ref_array(std::initializer_list<value_type> values) {
+    reserve(values.size());
+    for (auto const value : values) {
+      push_back(value);
+    }
+  }
+
+  size_type size() const noexcept { return m_values.size(); }
+  bool empty() const noexcept { return m_values.empty(); }
+
+  void reserve(size_type capacity) {
+    m_values.reserve(capacity);
+    m_present.reserve(word_count(capacity));
+  }
+
+  // New entries are empty.
+  void resize(size_type size) {
+    m_values.resize(size, nullptr);
+    m_present.resize(word_count(size), 0U);
+    clear_tail();
+  }
+
+  void clear() noexcept {
+    m_values.clear();
+    m_present.clear();
+  }
+
+  void push_back(value_type value) {
+    if ((m_values.size() % bits_per_word) == 0U) {
+      m_present.push_back(0U);
+    }
+    m_values.push_back(pointer_of(value));
+    assign_bit(m_values.size() - 1U, value.has_value());
+  }
+
+  void pop_back() noexcept {
+    assert(!empty());
+    assign_bit(m_values.size() - 1U, false);
+    m_values.pop_back();
+    if ((m_values.size() % bits_per_word) == 0U) {
+      m_present.pop_back();
+    }
+  }
+
+  value_type operator[](size_type index) const noexcept {
+    assert(index < size());
+    return make_ref(m_values[index]);
+  }
+
+  void set(size_type index, value_type value) noexcept {
+    assert(index < size());
+    m_values[index] = pointer_of(value);
+    assign_bit(index, value.has_value());
+  }
+
+  void reset(size_type index) noexcept { set(index, value_type{}); }
+
+  bool has_value(size_type index) const noexcept {
+    assert(index < size());
+    return ((m_present[index / bits_per_word] >> (index % bits_per_word)) & 1U) != 0U;
+  }
+
+  // Number of present entries.
+  size_type count() const noexcept {
+    size_type present{0};
+    for (auto const word : m_present) {
+      present += static_cast<size_type>(detail::popcount(word));
+    }
+    return present;
+  }
+
+  // Index of the first present entry at or after position, size() if there is none.
+  size_type find_next(size_type position) const noexcept {
+    if (position >= size()) {
+      return size();
+    }
+    auto word_index = position / bits_per_word;
+    auto word = m_present[word_index] & (~std::uint64_t{0} << (position % bits_per_word));
+    while (word == 0U) {
+      if (++word_index == m_present.size()) {
+        return size();
+      }
+      word = m_present[word_index];
+    }
+    return (word_index * bits_per_word) + static_cast<size_type>(detail::countr_zero(word));
+  }
+
+  const_iterator begin() const noexcept { return const_iterator{m_values.data()}; }
+  const_iterator end() const noexcept { return const_iterator{m_values.data() + size()}; }
+
+  present_range present() const noexcept {
+    return present_range{present_iterator{this, 0U}, present_iterator{this, size()}};
+  }
+
+ private:
+  static constexpr size_type bits_per_word = 64U;
+
+  static constexpr size_type word_count(size_type size) noexcept {
+    return (size + bits_per_word - 1U) / bits_per_word;
+  }
+
+  static pointer_type pointer_of(value_type value) noexcept {
+    return value.has_value() ? value.operator->() : nullptr;
+  }
+
+  static value_type make_ref(pointer_type value) noexcept {
+    return (value != nullptr) ? value_type{*value} : value_type{};
+  }
+
+  void assign_bit(size_type index, bool present) noexcept {
+    auto const mask = std::uint64_t{1} << (index % bits_per_word);
+    auto &word = m_present[index / bits_per_word];
+    word = present ? (word | mask) : (word & ~mask);
+  }
+
+  // Bits beyond size() stay clear, so whole words can be counted and searched.
+  void clear_tail() noexcept {
+    auto const used_bits = size() % bits_per_word;
+    if (used_bits != 0U) {
+      m_present.back() &= ~(~std::uint64_t{0} << used_bits);
+    }
+  }
+
+  std::vector<pointer_type> m_values{};
+  std::vector<std::uint64_t> m_present{};
+};
+
+}  // namespace me_std
+
+#endif  // ME_STD_OPTIONAL_REF_ARRAY_HPP
@@ -0,0 +1,575 @@
+#ifndef ME_STD_OPTIONAL_REF_BATCH_HPP
+#define ME_STD_OPTIONAL_REF_BATCH_HPP
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <me_std/optional_ref.hpp>
+#include <type_traits>
+#include <utility>
+
+// Checked refs are not plain pointers, so they are compared one at a time.
+#if !defined(ME_STD_DISABLE_SIMD) && !defined(ME_STD_CHECKED_REFS) && \
+    (defined(__GNUC__) || defined(__clang__)) && defined(__x86_64__)
+#define ME_STD_BATCH_AVX2 1
+#define ME_STD_BATCH_SSE41 1
+#include <immintrin.h>
+#endif
+
+namespace me_std {
+
+// Number of std::uint64_t words a result mask of count entries occupies.
+constexpr std::size_t batch_mask_size(std::size_t count) noexcept { return (count + 63U) / 64U; }
+
+namespace detail {
+
+enum class batch_compare { equal_to, less, greater };
+
+template <typename T>
+constexpr std::remove_reference_t<T> *pointer_of(optional_ref<T> ref) noexcept {
+  return ref.has_value() ? ref.operator->() : nullptr;
+}
+
+// Same results as the optional_ref operators, an empty ref orders first.
+template <batch_compare Compare, typename V>
+constexpr bool compare_value(V const *ref, V const &value) {
+  if (ref == nullptr) {
+    return Compare == batch_compare::less;
+  }
+  if constexpr (Compare == batch_compare::equal_to) {
+    return *ref == value;
+  } else if constexpr (Compare == batch_compare::less) {
+    return *ref < value;
+  } else {
+    return value < *ref;
+  }
+}
+
+template <batch_compare Compare, typename V>
+constexpr bool compare_refs(V const *lhs, V const *rhs) {
+  if constexpr (Compare == batch_compare::equal_to) {
+    return (lhs == rhs) || ((lhs != nullptr) && (rhs != nullptr) && (*lhs == *rhs));
+  } else if constexpr (Compare == batch_compare::less) {
+    return (lhs != rhs) && ((lhs == nullptr) || ((rhs != nullptr) && (*lhs < *rhs)));
+  } else {
+    return compare_refs<batch_compare::less>(rhs, lhs);
+  }
+}
+
+template <batch_compare Compare, typename T>
+void scalar_mask(optional_ref<T> const *refs, std::size_t count, std::decay_t<T> const &value,
+                 std::uint64_t *mask, std::size_t first = 0U) {
+  for (auto index = first; index < count; ++index) {
+    auto const bit = std::uint64_t{compare_value<Compare>(pointer_of(refs[index]), value)};
+    auto &word = mask[index / 64U];
+    word = ((index % 64U) == 0U) ? bit : (word | (bit << (index % 64U)));
+  }
+}
+
+template <batch_compare Compare, typename T>
+void scalar_mask(optional_ref<T> const *lhs, optional_ref<T> const *rhs, std::size_t count,
+                 std::uint64_t *mask, std::size_t first = 0U) {
+  for (auto index = first; index < count; ++index) {
+    auto const bit = std::uint64_t{compare_refs<Compare>(pointer_of(lhs[index]),
+                                                         pointer_of(rhs[index]))};
+    auto &word = mask[index / 64U];
+    word = ((index % 64U) == 0U) ? bit : (word | (bit << (index % 64U)));
+  }
+}
+
+template <typename V>
+constexpr bool has_simd_kernel = std::is_same<V, int>::value || std::is_same<V, double>::value;
+
+#if defined(ME_STD_BATCH_AVX2)
+
+inline bool has_avx2() noexcept {
+  static bool const supported = __builtin_cpu_supports("avx2");
+  return supported;
+}
+
+// Loads four optional_refs, which are laid out as plain pointers.
+template <typename T>
+__attribute__((target("avx2"))) inline __m256i load_pointers(optional_ref<T> const *refs) noexcept {
+  static_assert(sizeof(optional_ref<T>) == sizeof(std::uint64_t));
+  return _mm256_loadu_si256(reinterpret_cast<__m256i const *>(refs));
+}
+
+// Narrows the four 64-bit lanes of a mask to four 32-bit lanes.
+__attribute__((target("avx2"))) inline __m128i pack_lanes(__m256i lanes) noexcept {
+  return _mm256_castsi256_si128(
+      _mm256_permutevar8x32_epi32(lanes, _mm256_setr_epi32(0, 2, 4, 6, 0, 0, 0, 0)));
+}
+
+// Gathers the referents of four pointers, null pointers are not read. Returns
+// the lanes compared against value as a 4-bit mask.
+template <batch_compare Compare>
+__attribute__((target("avx2"))) inline unsigned gather_compare(__m256i pointers, __m256i present,
+                                                                int value) noexcept {
+  auto const values = _mm256_mask_i64gather_epi32(
+      _mm_setzero_si128(), static_cast<int const *>(nullptr), pointers, pack_lanes(present), 1);
+  auto const broadcast = _mm_set1_epi32(value);
+  __m128i result{};
+  if constexpr (Compare == batch_compare::equal_to) {
+    result = _mm_cmpeq_epi32(values, broadcast);
+  } else if constexpr (Compare == batch_compare::less) {
+    result = _mm_cmpgt_epi32(broadcast, values);
+  } else {
+    result = _mm_cmpgt_epi32(values, broadcast);
+  }
+  return static_cast<unsigned>(_mm_movemask_ps(_mm_castsi128_ps(result)));
+}
+
+template <batch_compare Compare>
+__attribute__((target("avx2"))) inline unsigned gather_compare(__m256i pointers, __m256i present,
+                                                                double value) noexcept {
+  auto const values =
+      _mm256_mask_i64gather_pd(_mm256_setzero_pd(), static_cast<double const *>(nullptr), pointers,
+                               _mm256_castsi256_pd(present), 1);
+  auto const broadcast = _mm256_set1_pd(value);
+  __m256d result{};
+  if constexpr (Compare == batch_compare::equal_to) {
+    result = _mm256_cmp_pd(values, broadcast, _CMP_EQ_OQ);
+  } else if constexpr (Compare == batch_compare::less) {
+    result = _mm256_cmp_pd(values, broadcast, _CMP_LT_OQ);
+  } else {
+    result = _mm256_cmp_pd(values, broadcast, _CMP_GT_OQ);
+  }
+  return static_cast<unsigned>(_mm256_movemask_pd(result));
+}
+
+// Gathers the referents of both sides and returns the compared lanes as a
+// 4-bit mask. Lanes outside present are not read.
+template <batch_compare Compare>
+__attribute__((target("avx2"))) inline unsigned gather_compare_pair(__m256i lhs_pointers,
+                                                                     __m256i rhs_pointers,
+                                                                     __m256i present,
+                                                                     int) noexcept {
+  auto const present32 = pack_lanes(present);
+  auto const *const base = static_cast<int const *>(nullptr);
+  auto const lhs =
+      _mm256_mask_i64gather_epi32(_mm_setzero_si128(), base, lhs_pointers, present32, 1);
+  auto const rhs =
+      _mm256_mask_i64gather_epi32(_mm_setzero_si128(), base, rhs_pointers, present32, 1);
+  __m128i result{};
+  if constexpr (Compare == batch_compare::equal_to) {
+    result = _mm_cmpeq_epi32(lhs, rhs);
+  } else if constexpr (Compare == batch_compare::less) {
+    result = _mm_cmpgt_epi32(rhs, lhs);
+  } else {
+    result = _mm_cmpgt_epi32(lhs, rhs);
+  }
+  return static_cast<unsigned>(_mm_movemask_ps(_mm_castsi128_ps(result)));
+}
+
+template <batch_compare Compare>
+__attribute__((target("avx2"))) inline unsigned gather_compare_pair(__m256i lhs_pointers,
+                                                                     __m256i rhs_pointers,
+                                                                     __m256i present,
+                                                                     double) noexcept {
+  auto const present64 = _mm256_castsi256_pd(present);
+  auto const *const base = static_cast<double const *>(nullptr);
+  auto const lhs =
+      _mm256_mask_i64gather_pd(_mm256_setzero_pd(), base, lhs_pointers, present64, 1);
+  auto const rhs =
+      _mm256_mask_i64gather_pd(_mm256_setzero_pd(), base, rhs_pointers, present64, 1);
+  __m256d result{};
+  if constexpr (Compare == batch_compare::equal_to) {
+    result = _mm256_cmp_pd(lhs, rhs, _CMP_EQ_OQ);
+  } else if constexpr (Compare == batch_compare::less) {
+    result = _mm256_cmp_pd(lhs, rhs, _CMP_LT_OQ);
+  } else {
+    result = _mm256_cmp_pd(lhs, rhs, _CMP_GT_OQ);
+  }
+  return static_cast<unsigned>(_mm256_movemask_pd(result));
+}
+
+template <batch_compare Compare, typename T>
+__attribute__((target("avx2"))) void avx2_mask(optional_ref<T> const *refs, std::size_t count,
+                                               std::decay_t<T> value, std::uint64_t *mask) {
+  auto const zero = _mm256_setzero_si256();
+  std::size_t index{0};
+  for (; index + 4U <= count; index += 4U) {
+    auto const pointers = load_pointers(refs + index);
+    auto const null = _mm256_cmpeq_epi64(pointers, zero);
+    auto const null_bits = static_cast<unsigned>(_mm256_movemask_pd(_mm256_castsi256_pd(null)));
+    auto bits = gather_compare<Compare>(pointers, _mm256_xor_si256(null, _mm256_set1_epi64x(-1)),
+                                        value) &
+                ~null_bits;
+    if constexpr (Compare == batch_compare::less) {
+      bits |= null_bits;
+    }
+    auto &word = mask[index / 64U];
+    word = ((index % 64U) == 0U) ? bits : (word | (std::uint64_t{bits} << (index % 64U)));
+  }
+  scalar_mask<Compare>(refs, count, value, mask, index);
+}
+
+// Gathers both sides and orders them like optional_ref::operator== and operator<.
+template <batch_compare Compare, typename T>
+__attribute__((target("avx2"))) void avx2_mask(optional_ref<T> const *lhs,
+                                               optional_ref<T> const *rhs, std::size_t count,
+                                               std::uint64_t *mask) {
+  using value_type = std::decay_t<T>;
+  auto const zero = _mm256_setzero_si256();
+  auto const ones = _mm256_set1_epi64x(-1);
+  std::size_t index{0};
+  for (; index + 4U <= count; index += 4U) {
+    auto const lhs_pointers = load_pointers(lhs + index);
+    auto const rhs_pointers = load_pointers(rhs + index);
+    auto const lhs_null = _mm256_cmpeq_epi64(lhs_pointers, zero);
+    auto const rhs_null = _mm256_cmpeq_epi64(rhs_pointers, zero);
+    auto const lhs_null_bits =
+        static_cast<unsigned>(_mm256_movemask_pd(_mm256_castsi256_pd(lhs_null)));
+    auto const rhs_null_bits =
+        static_cast<unsigned>(_mm256_movemask_pd(_mm256_castsi256_pd(rhs_null)));
+    auto const both_bits = ~(lhs_null_bits | rhs_null_bits) & 0xFU;
+
+    // Both sides are read as values of the other side, lanes with a null pointer are masked out.
+    auto const present = _mm256_xor_si256(_mm256_or_si256(lhs_null, rhs_null), ones);
+    std::uint64_t bits{};
+    if constexpr (Compare == batch_compare::equal_to) {
+      auto const same_bits = static_cast<unsigned>(_mm256_movemask_pd(
+          _mm256_castsi256_pd(_mm256_cmpeq_epi64(lhs_pointers, rhs_pointers))));
+      bits = same_bits | (both_bits & gather_compare_pair<Compare>(lhs_pointers, rhs_pointers,
+                                                                   present, value_type{}));
+    } else {
+      auto const first_null_bits =
+          (Compare == batch_compare::less) ? (lhs_null_bits & ~rhs_null_bits)
+                                           : (rhs_null_bits & ~lhs_null_bits);
+      bits = first_null_bits | (both_bits & gather_compare_pair<Compare>(
+                                                lhs_pointers, rhs_pointers, present, value_type{}));
+    }
+    auto &word = mask[index / 64U];
+    word = ((index % 64U) == 0U) ? bits : (word | (bits << (index % 64U)));
+  }
+  scalar_mask<Compare>(lhs, rhs, count, mask, index);
+}
+
+#endif
+
+#if defined(ME_STD_BATCH_SSE41)
+
+inline bool has_sse41() noexcept {
+  static bool const supported = __builtin_cpu_supports("sse4.1");
+  return supported;
+}
+
+// SSE4.1 has no gather, so the referents are read one at a time, an empty ref
+// as zero. The pointers are tested for null and the results blended four at a
+// time.
+template <typename T>
+std::decay_t<T> value_or_zero(optional_ref<T> ref) noexcept {
+  return ref.has_value() ? *ref : std::decay_t<T>{};
+}
+
+// Two optional_refs, which are laid out as plain pointers.
+template <typename T>
+__attribute__((target("sse4.1"))) inline __m128i load_pointer_pair(
+    optional_ref<T> const *refs) noexcept {
+  static_assert(sizeof(optional_ref<T>) == sizeof(std::uint64_t));
+  return _mm_loadu_si128(reinterpret_cast<__m128i const *>(refs));
+}
+
+template <batch_compare Compare>
+__attribute__((target("sse4.1"))) inline __m128i compare_lanes(__m128i lhs, __m128i rhs) noexcept {
+  if constexpr (Compare == batch_compare::equal_to) {
+    return _mm_cmpeq_epi32(lhs, rhs);
+  } else if constexpr (Compare == batch_compare::less) {
+    return _mm_cmpgt_epi32(rhs, lhs);
+  } else {
+    return _mm_cmpgt_epi32(lhs, rhs);
+  }
+}
+
+template <batch_compare Compare>
+__attribute__((target("sse4.1"))) inline __m128d compare_lanes(__m128d lhs, __m128d rhs) noexcept {
+  if constexpr (Compare == batch_compare::equal_to) {
+    return _mm_cmpeq_pd(lhs, rhs);
+  } else if constexpr (Compare == batch_compare::less) {
+    return _mm_cmplt_pd(lhs, rhs);
+  } else {
+    return _mm_cmpgt_pd(lhs, rhs);
+  }
+}
+
+// Compares four referents with value. The lanes with a null pointer take the
+// lanes of fill instead. Returns a 4-bit mask.
+template <batch_compare Compare, typename T>
+__attribute__((target("sse4.1"))) inline unsigned blend_compare(optional_ref<T> const *refs,
+                                                                 int value, __m128i null_low,
+                                                                 __m128i null_high,
+                                                                 __m128i fill) noexcept {
+  auto const values = _mm_setr_epi32(value_or_zero(refs[0]), value_or_zero(refs[1]),
+                                     value_or_zero(refs[2]), value_or_zero(refs[3]));
+  auto const null = _mm_castps_si128(_mm_shuffle_ps(
+      _mm_castsi128_ps(null_low), _mm_castsi128_ps(null_high), _MM_SHUFFLE(2, 0, 2, 0)));
+  auto const result =
+      _mm_blendv_epi8(compare_lanes<Compare>(values, _mm_set1_epi32(value)), fill, null);
+  return static_cast<unsigned>(_mm_movemask_ps(_mm_castsi128_ps(result)));
+}
+
+template <batch_compare Compare, typename T>
+__attribute__((target("sse4.1"))) inline unsigned blend_compare(optional_ref<T> const *refs,
+                                                                 double value, __m128i null_low,
+                                                                 __m128i null_high,
+                                                                 __m128i fill) noexcept {
+  auto const broadcast = _mm_set1_pd(value);
+  auto const low = _mm_blendv_pd(
+      compare_lanes<Compare>(_mm_setr_pd(value_or_zero(refs[0]), value_or_zero(refs[1])),
+                             broadcast),
+      _mm_castsi128_pd(fill), _mm_castsi128_pd(null_low));
+  auto const high = _mm_blendv_pd(
+      compare_lanes<Compare>(_mm_setr_pd(value_or_zero(refs[2]), value_or_zero(refs[3])),
+                             broadcast),
+      _mm_castsi128_pd(fill), _mm_castsi128_pd(null_high));
+  return static_cast<unsigned>(_mm_movemask_pd(low) | (_mm_movemask_pd(high) << 2));
+}
+
+// Compares four referents of both sides, whatever the pointers. Returns a 4-bit mask.
+template <batch_compare Compare, typename T>
+__attribute__((target("sse4.1"))) inline unsigned compare_pair(optional_ref<T> const *lhs,
+                                                                optional_ref<T> const *rhs,
+                                                                int) noexcept {
+  auto const lhs_values = _mm_setr_epi32(value_or_zero(lhs[0]), value_or_zero(lhs[1]),
+                                         value_or_zero(lhs[2]), value_or_zero(lhs[3]));
+  auto const rhs_values = _mm_setr_epi32(value_or_zero(rhs[0]), value_or_zero(rhs[1]),
+                                         value_or_zero(rhs[2]), value_or_zero(rhs[3]));
+  return static_cast<unsigned>(
+      _mm_movemask_ps(_mm_castsi128_ps(compare_lanes<Compare>(lhs_values, rhs_values))));
+}
+
+template <batch_compare Compare, typename T>
+__attribute__((target("sse4.1"))) inline unsigned compare_pair(optional_ref<T> const *lhs,
+                                                                optional_ref<T> const *rhs,
+                                                                double) noexcept {
+  auto const low =
+      compare_lanes<Compare>(_mm_setr_pd(value_or_zero(lhs[0]), value_or_zero(lhs[1])),
+                             _mm_setr_pd(value_or_zero(rhs[0]), value_or_zero(rhs[1])));
+  auto const high =
+      compare_lanes<Compare>(_mm_setr_pd(value_or_zero(lhs[2]), value_or_zero(lhs[3])),
+                             _mm_setr_pd(value_or_zero(rhs[2]), value_or_zero(rhs[3])));
+  return static_cast<unsigned>(_mm_movemask_pd(low) | (_mm_movemask_pd(high) << 2));
+}
+
+// Bit i of the result is set if pointer i of the four is null.
+__attribute__((target("sse4.1"))) inline unsigned lane_bits(__m128i low, __m128i high) noexcept {
+  return static_cast<unsigned>(_mm_movemask_pd(_mm_castsi128_pd(low)) |
+                               (_mm_movemask_pd(_mm_castsi128_pd(high)) << 2));
+}
+
+template <batch_compare Compare, typename T>
+__attribute__((target("sse4.1"))) void sse41_mask(optional_ref<T> const *refs, std::size_t count,
+                                                  std::decay_t<T> value, std::uint64_t *mask) {
+  auto const zero = _mm_setzero_si128();
+  // An empty ref is less than any value.
+  auto const fill = (Compare == batch_compare::less) ? _mm_set1_epi32(-1) : zero;
+  std::size_t index{0};
+  for (; index + 4U <= count; index += 4U) {
+    auto const null_low = _mm_cmpeq_epi64(load_pointer_pair(refs + index), zero);
+    auto const null_high = _mm_cmpeq_epi64(load_pointer_pair(refs + index + 2U), zero);
+    std::uint64_t const bits =
+        blend_compare<Compare>(refs + index, value, null_low, null_high, fill);
+    auto &word = mask[index / 64U];
+    word = ((index % 64U) == 0U) ? bits : (word | (bits << (index % 64U)));
+  }
+  scalar_mask<Compare>(refs, count, value, mask, index);
+}
+
+// Orders both sides like optional_ref::operator== and operator<, as avx2_mask.
+template <batch_compare Compare, typename T>
+__attribute__((target("sse4.1"))) void sse41_mask(optional_ref<T> const *lhs,
+                                                  optional_ref<T> const *rhs, std::size_t count,
+                                                  std::uint64_t *mask) {
+  using value_type = std::decay_t<T>;
+  auto const zero = _mm_setzero_si128();
+  std::size_t index{0};
+  for (; index + 4U <= count; index += 4U) {
+    auto const lhs_low = load_pointer_pair(lhs + index);
+    auto const lhs_high = load_pointer_pair(lhs + index + 2U);
+    auto const rhs_low = load_pointer_pair(rhs + index);
+    auto const rhs_high = load_pointer_pair(rhs + index + 2U);
+    auto const lhs_null_bits =
+        lane_bits(_mm_cmpeq_epi64(lhs_low, zero), _mm_cmpeq_epi64(lhs_high, zero));
+    auto const rhs_null_bits =
+        lane_bits(_mm_cmpeq_epi64(rhs_low, zero), _mm_cmpeq_epi64(rhs_high, zero));
+    auto const both_bits = ~(lhs_null_bits | rhs_null_bits) & 0xFU;
+    auto const compared_bits = compare_pair<Compare>(lhs + index, rhs + index, value_type{});
+
+    std::uint64_t bits{};
+    if constexpr (Compare == batch_compare::equal_to) {
+      auto const same_bits =
+          lane_bits(_mm_cmpeq_epi64(lhs_low, rhs_low), _mm_cmpeq_epi64(lhs_high, rhs_high));
+      bits = same_bits | (both_bits & compared_bits);
+    } else {
+      auto const first_null_bits =
+          (Compare == batch_compare::less) ? (lhs_null_bits & ~rhs_null_bits)
+                                           : (rhs_null_bits & ~lhs_null_bits);
+      bits = first_null_bits | (both_bits & compared_bits);
+    }
+    auto &word = mask[index / 64U];
+    word = ((index % 64U) == 0U) ? bits : (word | (bits << (index % 64U)));
+  }
+  scalar_mask<Compare>(lhs, rhs, count, mask, index);
+}
+
+#endif
+
+template <batch_compare Compare, typename T>
+void batch_mask(optional_ref<T> const *refs, std::size_t count, std::decay_t<T> const &value,
+                std::uint64_t *mask) {
+  if constexpr (has_simd_kernel<std::decay_t<T>>) {
+#if defined(ME_STD_BATCH_AVX2)
+    if (has_avx2()) {
+      avx2_mask<Compare>(refs, count, value, mask);
+      return;
+    }
+#endif
+#if defined(ME_STD_BATCH_SSE41)
+    if (has_sse41()) {
+      sse41_mask<Compare>(refs, count, value, mask);
+      return;
+    }
+#endif
+  }
+  scalar_mask<Compare>(refs, count, value, mask);
+}
+
+template <batch_compare Compare, typename T>
+void batch_mask(optional_ref<T> const *lhs, optional_ref<T> const *rhs, std::size_t count,
+                std::uint64_t *mask) {
+  if constexpr (has_simd_kernel<std::decay_t<T>>) {
+#if defined(ME_STD_BATCH_AVX2)
+    if (has_avx2()) {
+      avx2_mask<Compare>(lhs, rhs, count, mask);
+      return;
+    }
+#endif
+#if defined(ME_STD_BATCH_SSE41)
+    if (has_sse41()) {
+      sse41_mask<Compare>(lhs, rhs, count, mask);
+      return;
+    }
+#endif
+  }
+  scalar_mask<Compare>(lhs, rhs, count, mask);
+}
+
+// The optional_ref of a contiguous range of them, as in std::vector or std::array.
+template <typename Range>
+using batch_range_ref_t =
+    std::remove_cv_t<std::remove_pointer_t<decltype(std::data(std::declval<Range const &>()))>>;
+
+template <typename Range, typename = void>
+struct batch_range {};
+
+template <typename Range>
+struct batch_range<Range, std::enable_if_t<is_optional_ref<batch_range_ref_t<Range>>::value>> {
+  using value_type = typename batch_range_ref_t<Range>::value_type;
+};
+
+template <batch_compare Compare, typename Refs, typename Mask>
+void batch_range_mask(Refs const &refs, typename batch_range<Refs>::value_type const &value,
+                      Mask &&mask) {
+  assert(std::size(mask) >= batch_mask_size(std::size(refs)));
+  batch_mask<Compare>(std::data(refs), std::size(refs), value, std::data(mask));
+}
+
+template <batch_compare Compare, typename Refs, typename Mask,
+          typename = typename batch_range<Refs>::value_type>
+void batch_range_mask(Refs const &lhs, Refs const &rhs, Mask &&mask) {
+  assert(std::size(lhs) == std::size(rhs));
+  assert(std::size(mask) >= batch_mask_size(std::size(lhs)));
+  batch_mask<Compare>(std::data(lhs), std::data(rhs), std::size(lhs), std::data(mask));
+}
+
+}  // namespace detail
+
+// The batch comparisons write one bit per entry into mask, which must hold
+// batch_mask_size(count) words. Bit i of the result is found in word i / 64 at
+// position i % 64, bits beyond count are zero. Ranges of optional_ref<int> and
+// optional_ref<double> are compared four at a time when the CPU supports AVX2
+// or SSE4.1.
+
+// Sets the bits of the refs equal to value.
+template <typename T>
+void equal_to_mask(optional_ref<T> const *refs, std::size_t count, std::decay_t<T> const &value,
+                   std::uint64_t *mask) {
+  detail::batch_mask<detail::batch_compare::equal_to>(refs, count, value, mask);
+}
+
+// Sets the bits of the refs less than value, empty refs included.
+template <typename T>
+void less_mask(optional_ref<T> const *refs, std::size_t count, std::decay_t<T> const &value,
+               std::uint64_t *mask) {
+  detail::batch_mask<detail::batch_compare::less>(refs, count, value, mask);
+}
+
+// Sets the bits of the refs greater than value.
+template <typename T>
+void greater_mask(optional_ref<T> const *refs, std::size_t count, std::decay_t<T> const &value,
+                  std::uint64_t *mask) {
+  detail::batch_mask<detail::batch_compare::greater>(refs, count, value, mask);
+}
+
+// Sets bit i if lhs[i] == rhs[i].
+template <typename T>
+void equal_to_mask(optional_ref<T> const *lhs, optional_ref<T> const *rhs, std::size_t count,
+                   std::uint64_t *mask) {
+  detail::batch_mask<detail::batch_compare::equal_to>(lhs, rhs, count, mask);
+}
+
+// Sets bit i if lhs[i] < rhs[i].
+template <typename T>
+void less_mask(optional_ref<T> const *lhs, optional_ref<T> const *rhs, std::size_t count,
+               std::uint64_t *mask) {
+  detail::batch_mask<detail::batch_compare::less>(lhs, rhs, count, mask);
+}
+
+// Sets bit i if lhs[i] > rhs[i].
+template <typename T>
+void greater_mask(optional_ref<T> const *lhs, optional_ref<T> const *rhs, std::size_t count,
+                  std::uint64_t *mask) {
+  detail::batch_mask<detail::batch_compare::greater>(lhs, rhs, count, mask);
+}
+
+// The same for contiguous ranges of optional_ref, such as a std::vector, and a
+// range of batch_mask_size(std::size(refs)) mask words. Both sides of an
+// element-wise comparison have the same size.
+
+template <typename Refs, typename Mask>
+void equal_to_mask(Refs const &refs, typename detail::batch_range<Refs>::value_type const &value,
+                   Mask &&mask) {
+  detail::batch_range_mask<detail::batch_compare::equal_to>(refs, value, mask);
+}
+
+template <typename Refs, typename Mask>
+void less_mask(Refs const &refs, typename detail::batch_range<Refs>::value_type const &value,
+               Mask &&mask) {
+  detail::batch_range_mask<detail::batch_compare::less>(refs, value, mask);
+}
+
+template <typename Refs, typename Mask>
+void greater_mask(Refs const &refs, typename detail::batch_range<Refs>::value_type const &value,
+                  Mask &&mask) {
+  detail::batch_range_mask<detail::batch_compare::greater>(refs, value, mask);
+}
+
+template <typename Refs, typename Mask, typename = typename detail::batch_range<Refs>::value_type>
+void equal_to_mask(Refs const &lhs, Refs const &rhs, Mask &&mask) {
+  detail::batch_range_mask<detail::batch_compare::equal_to>(lhs, rhs, mask);
+}
+
+template <typename Refs, typename Mask, typename = typename detail::batch_range<Refs>::value_type>
+void less_mask(Refs const &lhs, Refs const &rhs, Mask &&mask) {
+  detail::batch_range_mask<detail::batch_compare::less>(lhs, rhs, mask);
+}
+
+template <typename Refs, typename Mask, typename = typename detail::batch_range<Refs>::value_type>
+void greater_mask(Refs const &lhs, Refs const &rhs, Mask &&mask) {
+  detail::batch_range_mask<detail::batch_compare::greater>(lhs, rhs, mask);
+}
+
+}  // namespace me_std
+
+#endif  // ME_STD_OPTIONAL_REF_BATCH_HPP
@@ -0,0 +1,209 @@
+#ifndef ME_STD_OPTIONAL_SPAN_HPP
+#define ME_STD_OPTIONAL_SPAN_HPP
+
+#include <cassert>
+#include <cstddef>
+#include <iterator>
+#include <me_std/compare_traits.hpp>
+#include <optional>
+#include <type_traits>
+#include <utility>
+
+namespace me_std {
+
+template <typename T>
+class optional_span;
+
+namespace detail {
+
+template <typename T>
+struct is_optional_span : std::false_type {};
+
+template <typename T>
+struct is_optional_span<optional_span<T>> : std::true_type {};
+
+template <typename Container, typename T, typename = void>
+struct is_span_compatible : std::false_type {};
+
+// Contiguous containers and arrays whose elements a T * may point to.
+template <typename Container, typename T>
+struct is_span_compatible<Container, T,
+                          std::void_t<decltype(std::data(std::declval<Container &>())),
+                                      decltype(std::size(std::declval<Container &>()))>>
+    : std::bool_constant<
+          !is_optional_span<std::remove_cv_t<Container>>::value &&
+          !is_std_optional<std::remove_cv_t<Container>>::value &&
+          std::is_convertible<std::remove_pointer_t<decltype(std::data(
+                                  std::declval<Container &>()))> (*)[],
+                              T (*)[]>::value> {};
+
+template <typename Container, typename T>
+using enable_if_span_compatible = std::enable_if_t<is_span_compatible<Container, T>::value>;
+
+// Stands in for the data of a present but empty container that reports none,
+// so it does not look absent. It is never dereferenced.
+template <typename T>
+T *present_empty_data() noexcept {
+  alignas(T) static unsigned char storage[sizeof(T)]{};
+  return reinterpret_cast<T *>(storage);
+}
+
+}  // namespace detail
+
+// Non-owning view of a contiguous sequence of T that may be absent, the
+// optional_ref of buffers. It is a pointer and a size; a null pointer means
+// absent. A present sequence may be empty.
+template <typename T>
+class optional_span {
+  static_assert(std::is_object<T>::value && !std::is_abstract<T>::value,
+                "Template argument T must be an element type.");
+
+ public:
+  using element_type = T;
+  using value_type = std::remove_cv_t<T>;
+  using size_type = std::size_t;
+  using difference_type = std::ptrdiff_t;
+  using pointer = T *;
+  using reference = T &;
+  using iterator = T *;
+
+  constexpr optional_span() noexcept = default;
+
+  // Absent if data is null.
+  constexpr optional_span(pointer data, size_type size) noexcept
+      : m_data{data}, m_size{(data != nullptr) ? size : 0U} {}
+
+  // In constant expressions, only containers that report data can be viewed.
+  template <typename Container, typename = detail::enable_if_span_compatible<Container, T>>
+  constexpr optional_span(Container &container) noexcept
+      : m_data{std::data(container)}, m_size{static_cast<size_type>(std::size(container))} {
+    if (m_data == nullptr) {
+      m_data = detail::present_empty_data<T>();
+    }
+  }
+
+  template <typename Container, typename = detail::enable_if_span_compatible<Container, T>>
+  constexpr optional_span(std::optional<Container> &optional) noexcept
+      : optional_span{optional.has_value() ? optional_span{*optional} : optional_span{}} {}
+
+  template <typename Container,
+            typename = detail::enable_if_span_compatible<Container const, T>>
+  constexpr optional_span(std::optional<Container> const &optional) noexcept
+      : optional_span{optional.has_value() ? optional_span{*optional} : optional_span{}} {}
+
+  template <typename U, typename = std::enable_if_t<!std::is_same<U, T>::value &&
+                                                    std::is_convertible<U (*)[], T (*)[]>::value>>
+  constexpr optional_span(optional_span<U> other) noexcept
+      : m_data{other.data()}, m_size{other.size()} {}
+
+  constexpr bool has_value() const noexcept { return m_data != nullptr; }
+
+  constexpr pointer data() const noexcept { return m_data; }
+  constexpr size_type size() const noexcept { return m_size; }
+  constexpr size_type size_bytes() const noexcept { return m_size * sizeof(T); }
+  // An absent sequence is empty, too.
+  constexpr bool empty() const noexcept { return m_size == 0U; }
+
+  constexpr iterator begin() const noexcept { return m_data; }
+  constexpr iterator end() const noexcept { return m_data + m_size; }
+
+  constexpr reference operator[](size_type index) const noexcept {
+    assert(index < m_size);
+    return m_data[index];
+  }
+
+  constexpr reference front() const noexcept {
+    assert(!empty());
+    return *m_data;
+  }
+
+  constexpr reference back() const noexcept {
+    assert(!empty());
+    return m_data[m_size - 1U];
+  }
+
+  // The count elements from offset on, absent if this is.
+  constexpr optional_span subspan(size_type offset, size_type count) const noexcept {
+    assert((offset <= m_size) && (count <= (m_size - offset)));
+    return has_value() ? optional_span{m_data + offset, count} : optional_span{};
+  }
+
+ private:
+  pointer m_data{nullptr};
+  size_type m_size{0U};
+};
+
+template <typename Container>
+optional_span(Container &) -> optional_span<std::remove_pointer_t<decltype(std::data(
+    std::declval<Container &>()))>>;
+
+template <typename Container>
+optional_span(std::optional<Container> &) -> optional_span<std::remove_pointer_t<decltype(
+    std::data(std::declval<Container &>()))>>;
+
+template <typename Container>
+optional_span(std::optional<Container> const &) -> optional_span<std::remove_pointer_t<decltype(
+    std::data(std::declval<Container const &>()))>>;
+
+// Compared like optional_ref: absent equals absent and is less than every
+// present sequence, present sequences compare their elements lexicographically.
+
+template <typename T, typename U>
+constexpr bool operator==(optional_span<T> lhs, optional_span<U> rhs) {
+  if (lhs.has_value() != rhs.has_value()) {
+    return false;
+  }
+  if ((lhs.size() != rhs.size()) || (lhs.data() == rhs.data())) {
+    return lhs.size() == rhs.size();
+  }
+  for (std::size_t index = 0U; index < lhs.size(); ++index) {
+    if (!(lhs[index] == rhs[index])) {
+      return false;
+    }
+  }
+  return true;
+}
+
+template <typename T, typename U>
+constexpr bool operator<(optional_span<T> lhs, optional_span<U> rhs) {
+  if (!rhs.has_value()) {
+    return false;
+  }
+  if (!lhs.has_value()) {
+    return true;
+  }
+  auto const size = (lhs.size() < rhs.size()) ? lhs.size() : rhs.size();
+  for (std::size_t index = 0U; index < size; ++index) {
+    if (lhs[index] < rhs[index]) {
+      return true;
+    }
+    if (rhs[index] < lhs[index]) {
+      return false;
+    }
+  }
+  return lhs.size() < rhs.size();
+}
+
+template <typename T, typename U>
+constexpr bool operator!=(optional_span<T> lhs, optional_span<U> rhs) {
+  return !(lhs == rhs);
+}
+
+template <typename T, typename U>
+constexpr bool operator<=(optional_span<T> lhs, optional_span<U> rhs) {
+  return !(rhs < lhs);
+}
+
+template <typename T, typename U>
+constexpr bool operator>(optional_span<T> lhs, optional_span<U> rhs) {
+  return rhs < lhs;
+}
+
+template <typename T, typename U>
+constexpr bool operator>=(optional_span<T> lhs, optional_span<U> rhs) {
+  return !(lhs < rhs);
+}
+
+}  // namespace me_std
+
+#endif  // ME_STD_OPTIONAL_SPAN_HPP
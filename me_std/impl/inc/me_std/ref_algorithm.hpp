@@ -0,0 +1,315 @@
+#ifndef ME_STD_REF_ALGORITHM_HPP
+#define ME_STD_REF_ALGORITHM_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <iterator>
+#include <me_std/deferred_ref.hpp>
+#include <me_std/optional_ref.hpp>
+#include <me_std/safe_ref.hpp>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+namespace me_std {
+
+// Maps a value to an unsigned key whose order agrees with operator< of the
+// value. An exact key decides every comparison on its own, otherwise equal keys
+// fall back to comparing the values. Specialize it to speed up sorting refs of
+// further types.
+template <typename T, typename = void>
+struct ref_sort_key {};
+
+template <typename T>
+struct ref_sort_key<T, std::enable_if_t<(std::is_integral<T>::value || std::is_enum<T>::value) &&
+                                        (sizeof(T) <= sizeof(std::uint64_t))>> {
+  static constexpr bool exact = true;
+
+  static std::uint64_t key(T value) noexcept {
+    using integral_type = typename std::conditional_t<std::is_enum<T>::value, std::underlying_type<T>,
+                                                      std::common_type<T>>::type;
+    auto const integral = static_cast<integral_type>(value);
+    if constexpr (std::is_signed<integral_type>::value) {
+      return static_cast<std::uint64_t>(static_cast<std::int64_t>(integral)) ^
+             (std::uint64_t{1} << 63U);
+    } else {
+      return static_cast<std::uint64_t>(integral);
+    }
+  }
+};
+
+template <typename T>
+struct ref_sort_key<T, std::enable_if_t<std::is_same<T, float>::value ||
+                                        std::is_same<T, double>::value>> {
+  static constexpr bool exact = true;
+
+  // Negative values have their bits inverted, so they order below the positive
+  // ones. Both zeros map to the key of +0.0.
+  static std::uint64_t key(T value) noexcept {
+    auto const wide = (value == T{0}) ? 0.0 : static_cast<double>(value);
+    std::uint64_t bits{};
+    std::memcpy(&bits, &wide, sizeof(bits));
+    return ((bits >> 63U) != 0U) ? ~bits : (bits | (std::uint64_t{1} << 63U));
+  }
+};
+
+// The first eight characters in big-endian order. Characters compare as
+// unsigned char, like std::char_traits<char>::lt does.
+template <>
+struct ref_sort_key<std::string_view> {
+  static constexpr bool exact = false;
+
+  static std::uint64_t key(std::string_view value) noexcept {
+    std::uint64_t prefix{0};
+    auto const length = std::min<std::size_t>(value.size(), sizeof(prefix));
+    for (std::size_t index = 0; index < sizeof(prefix); ++index) {
+      prefix <<= 8U;
+      if (index < length) {
+        prefix |= static_cast<unsigned char>(value[index]);
+      }
+    }
+    return prefix;
+  }
+};
+
+template <typename Allocator>
+struct ref_sort_key<std::basic_string<char, std::char_traits<char>, Allocator>> {
+  static constexpr bool exact = false;
+
+  static std::uint64_t key(std::basic_string<char, std::char_traits<char>, Allocator> const &value) {
+    return ref_sort_key<std::string_view>::key(value);
+  }
+};
+
+namespace detail {
+
+template <typename T, typename = void>
+struct has_ref_sort_key : std::false_type {};
+
+template <typename T>
+struct has_ref_sort_key<T, std::void_t<decltype(ref_sort_key<T>::exact)>> : std::true_type {};
+
+// Refs that always have a value and are moved rather than rebuilt from a
+// pointer, which would lose what they own.
+template <typename T>
+struct is_safe_ref : std::false_type {};
+
+template <typename T, typename A>
+struct is_safe_ref<safe_ref<T, A>> : std::true_type {};
+
+template <typename T, ref_threading Threading>
+struct is_safe_ref<deferred_ref<T, Threading>> : std::true_type {};
+
+// The referent of a ref, nullptr for an empty optional_ref.
+template <typename T>
+auto referent_address(optional_ref<T> ref) noexcept {
+  return ref.has_value() ? ref.operator->() : nullptr;
+}
+
+template <typename T, typename A>
+auto referent_address(safe_ref<T, A> const &ref) noexcept {
+  return std::addressof(*ref);
+}
+
+template <typename T, ref_threading Threading>
+auto referent_address(deferred_ref<T, Threading> const &ref) noexcept {
+  return std::addressof(*ref);
+}
+
+template <typename T>
+inline void prefetch(T const *address) noexcept {
+#if defined(__GNUC__) || defined(__clang__)
+  __builtin_prefetch(address);
+#else
+  static_cast<void>(address);
+#endif
+}
+
+// Distance in elements at which referents are prefetched ahead of their use.
+constexpr std::ptrdiff_t prefetch_distance = 16;
+
+// A present ref along with the sort key of its referent. Sorting these keeps
+// most comparisons within the contiguous records.
+template <typename Pointer>
+struct decorated_ref {
+  std::uint64_t key;
+  Pointer value;
+};
+
+// A decorated_ref that also remembers where in the range its ref came from.
+template <typename Pointer>
+struct indexed_decorated_ref : decorated_ref<Pointer> {
+  std::ptrdiff_t index;
+};
+
+template <typename T>
+struct decorated_less {
+  template <typename Pointer>
+  bool operator()(decorated_ref<Pointer> const &lhs, decorated_ref<Pointer> const &rhs) const {
+    if constexpr (ref_sort_key<T>::exact) {
+      return lhs.key < rhs.key;
+    } else {
+      return (lhs.key < rhs.key) || ((lhs.key == rhs.key) && (*lhs.value < *rhs.value));
+    }
+  }
+};
+
+template <typename RandomIt>
+using sorted_ref_t = typename std::iterator_traits<RandomIt>::value_type;
+
+template <typename RandomIt>
+using sorted_value_t = typename sorted_ref_t<RandomIt>::value_type;
+
+template <typename RandomIt>
+using sorted_key_t = has_ref_sort_key<sorted_value_t<RandomIt>>;
+
+inline constexpr auto is_empty_ref = [](auto const &ref) { return !ref.has_value(); };
+
+// Sorts the present refs in [first, last) through decorated records, then
+// writes them back in order.
+template <typename RandomIt, typename Sort>
+void sort_decorated(RandomIt first, RandomIt last, Sort sort) {
+  using ref_type = sorted_ref_t<RandomIt>;
+  using value_type = sorted_value_t<RandomIt>;
+  using record_type = decorated_ref<typename ref_type::pointer_type>;
+
+  std::vector<record_type> records{};
+  records.reserve(static_cast<std::size_t>(last - first));
+  for (auto it = first; it != last; ++it) {
+    if ((last - it) > prefetch_distance) {
+      prefetch(referent_address(it[prefetch_distance]));
+    }
+    auto const value = referent_address(*it);
+    records.push_back(record_type{ref_sort_key<value_type>::key(*value), value});
+  }
+
+  sort(records.begin(), records.end(), decorated_less<value_type>{});
+
+  for (auto const &record : records) {
+    *first++ = ref_type{*record.value};
+  }
+}
+
+// Like sort_decorated, for safe_refs, which may own their referent and so are
+// moved into their place instead of rebuilt from the pointer. The sorted
+// records name the position each ref comes from, and the refs follow the
+// cycles of that permutation in place.
+template <typename RandomIt, typename Sort>
+void sort_decorated_indexed(RandomIt first, RandomIt last, Sort sort) {
+  using ref_type = sorted_ref_t<RandomIt>;
+  using value_type = sorted_value_t<RandomIt>;
+  using record_type = indexed_decorated_ref<value_type const *>;
+
+  auto const count = last - first;
+  std::vector<record_type> records{};
+  records.reserve(static_cast<std::size_t>(count));
+  for (std::ptrdiff_t index = 0; index < count; ++index) {
+    if ((count - index) > prefetch_distance) {
+      prefetch(referent_address(first[index + prefetch_distance]));
+    }
+    auto const *const value = referent_address(first[index]);
+    records.push_back(record_type{{ref_sort_key<value_type>::key(*value), value}, index});
+  }
+
+  sort(records.begin(), records.end(), decorated_less<value_type>{});
+
+  for (std::ptrdiff_t start = 0; start < count; ++start) {
+    if (records[start].index == start) {
+      continue;
+    }
+    ref_type held{std::move(first[start])};
+    auto position = start;
+    for (;;) {
+      auto const source = records[position].index;
+      records[position].index = position;
+      if (source == start) {
+        first[position] = std::move(held);
+        break;
+      }
+      first[position] = std::move(first[source]);
+      position = source;
+    }
+  }
+}
+
+// Sorts [first, last), in which every ref has a value, with sort.
+template <typename RandomIt, typename Sort>
+void sort_present(RandomIt first, RandomIt last, Sort sort) {
+  if constexpr (!sorted_key_t<RandomIt>::value) {
+    sort(first, last, std::less<>{});
+  } else if constexpr (is_safe_ref<sorted_ref_t<RandomIt>>::value) {
+    sort_decorated_indexed(first, last, sort);
+  } else {
+    sort_decorated(first, last, sort);
+  }
+}
+
+// Sorts a range of optional_ref, safe_ref or deferred_ref with sort, empty
+// refs first.
+template <typename RandomIt, typename Partition, typename Sort>
+void sort_refs(RandomIt first, RandomIt last, Partition partition, Sort sort) {
+  if constexpr (is_safe_ref<sorted_ref_t<RandomIt>>::value) {
+    sort_present(first, last, sort);
+  } else {
+    sort_present(partition(first, last, is_empty_ref), last, sort);
+  }
+}
+
+}  // namespace detail
+
+// Sorts a range of optional_ref, safe_ref or deferred_ref into the order of
+// operator<, empty refs first. For referents with a ref_sort_key the refs are
+// sorted as contiguous records of key and pointer, so the scattered referents
+// are read once, in order, instead of at every comparison. safe_refs and
+// deferred_refs are moved into place, so sorting never copies a referent.
+template <typename RandomIt>
+void sort_refs(RandomIt first, RandomIt last) {
+  detail::sort_refs(
+      first, last,
+      [](auto begin, auto end, auto predicate) { return std::partition(begin, end, predicate); },
+      [](auto begin, auto end, auto less) { std::sort(begin, end, less); });
+}
+
+// Like sort_refs, but keeps the order of equal refs.
+template <typename RandomIt>
+void stable_sort_refs(RandomIt first, RandomIt last) {
+  detail::sort_refs(
+      first, last,
+      [](auto begin, auto end, auto predicate) {
+        return std::stable_partition(begin, end, predicate);
+      },
+      [](auto begin, auto end, auto less) { std::stable_sort(begin, end, less); });
+}
+
+// Finds the first ref not less than value in a range sorted by sort_refs. The
+// search halves the range without branching and prefetches the referents of
+// both possible next probes while the current one is compared.
+template <typename RandomIt, typename Value>
+RandomIt lower_bound_refs(RandomIt first, RandomIt last, Value const &value) {
+  auto length = last - first;
+  if (length == 0) {
+    return first;
+  }
+  while (length > 1) {
+    auto const half = length / 2;
+    auto const next_half = (length - half) / 2;
+    if (auto const *const probe = detail::referent_address(first[next_half])) {
+      detail::prefetch(probe);
+    }
+    if (auto const *const probe = detail::referent_address(first[half + next_half])) {
+      detail::prefetch(probe);
+    }
+    first = (first[half] < value) ? (first + half) : first;
+    length -= half;
+  }
+  return (*first < value) ? (first + 1) : first;
+}
+
+}  // namespace me_std
+
+#endif  // ME_STD_REF_ALGORITHM_HPP
@@ -0,0 +1,141 @@
+#ifndef ME_STD_REF_HASH_HPP
+#define ME_STD_REF_HASH_HPP
+
+#include <cstddef>
+#include <functional>
+#include <me_std/deferred_ref.hpp>
+#include <me_std/optional_ref.hpp>
+#include <me_std/safe_ref.hpp>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+
+namespace me_std {
+
+namespace detail {
+
+// Resolves every lookup key to the T it refers to, nullptr for an empty optional_ref.
+// Only a T itself is taken by address, a key that converts to a T would bind
+// to a temporary.
+template <typename T>
+struct ref_lookup {
+  template <typename U, typename = std::enable_if_t<std::is_same<std::decay_t<U>, T>::value>>
+  static constexpr T const *pointer(U const &value) noexcept {
+    return std::addressof(value);
+  }
+
+  static constexpr T const *pointer(std::reference_wrapper<T> ref) noexcept {
+    return std::addressof(ref.get());
+  }
+
+  static constexpr T const *pointer(std::reference_wrapper<T const> ref) noexcept {
+    return std::addressof(ref.get());
+  }
+
+  static constexpr T const *pointer(optional_ref<T &> ref) noexcept {
+    return ref.has_value() ? ref.operator->() : nullptr;
+  }
+
+  static constexpr T const *pointer(optional_ref<T const &> ref) noexcept {
+    return ref.has_value() ? ref.operator->() : nullptr;
+  }
+
+  template <typename Allocator>
+  static constexpr T const *pointer(safe_ref<T &, Allocator> const &ref) noexcept {
+    return std::addressof(*ref);
+  }
+
+  template <typename Allocator>
+  static constexpr T const *pointer(safe_ref<T const &, Allocator> const &ref) noexcept {
+    return std::addressof(*ref);
+  }
+
+  template <ref_threading Threading>
+  static T const *pointer(deferred_ref<T const &, Threading> const &ref) noexcept {
+    return std::addressof(*ref);
+  }
+};
+
+template <typename T, typename Key, typename = void>
+struct is_ref_lookup_key : std::false_type {};
+
+template <typename T, typename Key>
+struct is_ref_lookup_key<T, Key,
+                         std::void_t<decltype(ref_lookup<T>::pointer(std::declval<Key const &>()))>>
+    : std::true_type {};
+
+// A type that hashes and compares like T and is cheaper to convert a key to.
+// std::hash of a std::basic_string_view agrees with that of the string.
+template <typename T>
+struct lookup_view {
+  using type = T;
+};
+
+template <typename Char, typename Traits, typename Allocator>
+struct lookup_view<std::basic_string<Char, Traits, Allocator>> {
+  using type = std::basic_string_view<Char, Traits>;
+};
+
+// Calls function with a pointer to the T key refers to. Keys that convert to
+// the lookup_view of T, such as a char const * for a std::string, are viewed
+// without a copy. Any other key is converted to a T that lives for the call.
+template <typename T, typename Key, typename Function>
+decltype(auto) with_lookup_value(Key const &key, Function &&function) {
+  using view_type = typename lookup_view<T>::type;
+  if constexpr (is_ref_lookup_key<T, Key>::value) {
+    return std::forward<Function>(function)(ref_lookup<T>::pointer(key));
+  } else if constexpr (!std::is_same<view_type, T>::value &&
+                       std::is_convertible<Key const &, view_type>::value) {
+    view_type const view(key);
+    return std::forward<Function>(function)(std::addressof(view));
+  } else {
+    T const value(key);
+    return std::forward<Function>(function)(std::addressof(value));
+  }
+}
+
+}  // namespace detail
+
+// Transparent hash for containers keyed by T. T, optional_ref, safe_ref,
+// deferred_ref and std::reference_wrapper of a T hash alike, so each of them
+// finds an element without a temporary key. For a std::string a char const *
+// or std::string_view hashes as a view of it. Any other key hashes as the T it
+// converts to.
+template <typename T>
+struct ref_hash {
+  using is_transparent = void;
+
+  template <typename Key>
+  std::size_t operator()(Key const &key) const {
+    return detail::with_lookup_value<T>(key, [](auto const *value) {
+      using value_type = std::remove_const_t<std::remove_pointer_t<decltype(value)>>;
+      return (value != nullptr) ? std::hash<value_type>{}(*value)
+                                : detail::optional_ref_empty_hash;
+    });
+  }
+};
+
+// Transparent equality matching ref_hash. An empty optional_ref only equals
+// another empty optional_ref.
+template <typename T>
+struct ref_equal_to {
+  using is_transparent = void;
+
+  template <typename Lhs, typename Rhs>
+  bool operator()(Lhs const &lhs, Rhs const &rhs) const {
+    return detail::with_lookup_value<T>(lhs, [&rhs](auto const *lhs_value) {
+      return detail::with_lookup_value<T>(rhs, [lhs_value](auto const *rhs_value) {
+        if ((lhs_value == nullptr) || (rhs_value == nullptr)) {
+          return (lhs_value == nullptr) && (rhs_value == nullptr);
+        }
+        return *lhs_value == *rhs_value;
+      });
+    });
+  }
+};
+
+}  // namespace me_std
+
+#endif  // ME_STD_REF_HASH_HPP
@@ -0,0 +1,122 @@
+#ifndef ME_STD_REF_LIFETIME_HPP
+#define ME_STD_REF_LIFETIME_HPP
+
+#include <type_traits>
+#if defined(ME_STD_CHECKED_REFS)
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <mutex>
+#include <unordered_map>
+#endif
+
+// Defining ME_STD_CHECKED_REFS for a whole program makes every optional_ref
+// check on dereference that a referent registered through ref_lifetime is
+// still alive. Without it ref_lifetime is empty and optional_ref a bare
+// pointer.
+
+namespace me_std {
+
+namespace detail {
+
+constexpr bool is_constant_evaluated() noexcept {
+#if defined(__cpp_lib_is_constant_evaluated)
+  return std::is_constant_evaluated();
+#elif defined(__GNUC__) && (__GNUC__ >= 9)
+  return __builtin_is_constant_evaluated();
+#elif defined(__has_builtin)
+#if __has_builtin(__builtin_is_constant_evaluated)
+  return __builtin_is_constant_evaluated();
+#else
+  return false;
+#endif
+#else
+  return false;
+#endif
+}
+
+#if defined(ME_STD_CHECKED_REFS)
+
+// Generation of the referent an optional_ref was bound to, 0 if it is untracked.
+using ref_generation = std::uint64_t;
+
+// The addresses of the live registered referents. A referent that reappears at
+// an address gets a new generation, so refs to its predecessor stay dangling.
+class ref_registry {
+ public:
+  static ref_registry &instance() {
+    static ref_registry registry{};
+    return registry;
+  }
+
+  ref_generation add(void const *address) {
+    std::lock_guard<std::mutex> const lock{m_mutex};
+    auto const generation = ++m_last_generation;
+    m_live[address] = generation;
+    return generation;
+  }
+
+  void remove(void const *address, ref_generation generation) {
+    std::lock_guard<std::mutex> const lock{m_mutex};
+    auto const live = m_live.find(address);
+    if ((live != m_live.end()) && (live->second == generation)) {
+      m_live.erase(live);
+    }
+  }
+
+  ref_generation find(void const *address) const {
+    std::lock_guard<std::mutex> const lock{m_mutex};
+    auto const live = m_live.find(address);
+    return (live != m_live.end()) ? live->second : 0U;
+  }
+
+  bool is_alive(void const *address, ref_generation generation) const {
+    return find(address) == generation;
+  }
+
+ private:
+  ref_registry() = default;
+
+  mutable std::mutex m_mutex{};
+  ref_generation m_last_generation{0};
+  std::unordered_map<void const *, ref_generation> m_live{};
+};
+
+[[noreturn]] inline void report_dangling(void const *address) noexcept {
+  std::fprintf(stderr, "me_std: dereferenced a dangling optional_ref to %p\n", address);
+  std::abort();
+}
+
+#endif
+
+}  // namespace detail
+
+// Registers a referent for the checks of ME_STD_CHECKED_REFS while it lives.
+// Declare it right after the referent, so it ends before the referent does.
+// One ref_lifetime per address, an object and its first member can not both
+// be registered.
+class ref_lifetime {
+ public:
+#if defined(ME_STD_CHECKED_REFS)
+  template <typename T>
+  explicit ref_lifetime(T const &referent)
+      : m_address{&referent}, m_generation{detail::ref_registry::instance().add(&referent)} {}
+  ~ref_lifetime() { detail::ref_registry::instance().remove(m_address, m_generation); }
+#else
+  template <typename T>
+  explicit ref_lifetime(T const &) noexcept {}
+#endif
+
+  ref_lifetime(ref_lifetime const &) = delete;
+  ref_lifetime &operator=(ref_lifetime const &) = delete;
+
+#if defined(ME_STD_CHECKED_REFS)
+ private:
+  void const *m_address;
+  detail::ref_generation m_generation;
+#endif
+};
+
+}  // namespace me_std
+
+#endif  // ME_STD_REF_LIFETIME_HPP
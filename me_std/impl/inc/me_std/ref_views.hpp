@@ -0,0 +1,79 @@
+#ifndef ME_STD_REF_VIEWS_HPP
+#define ME_STD_REF_VIEWS_HPP
+
+#include <me_std/optional_ref.hpp>
+#include <optional>
+#include <type_traits>
+#include <utility>
+#if __has_include(<ranges>)
+#include <ranges>
+#endif
+
+#if defined(__cpp_lib_ranges)
+
+namespace me_std {
+
+namespace detail {
+
+struct has_value_fn {
+  template <typename R>
+  constexpr bool operator()(R const &ref) const noexcept {
+    return ref.has_value();
+  }
+};
+
+struct deref_fn {
+  template <typename R>
+  constexpr decltype(auto) operator()(R &&ref) const noexcept {
+    static_assert(std::is_lvalue_reference<decltype(*std::forward<R>(ref))>::value,
+                  "Dereferencing must yield a reference that outlives the element.");
+    return *std::forward<R>(ref);
+  }
+};
+
+struct as_optional_ref_fn {
+  template <typename V>
+  constexpr optional_ref<V &> operator()(V *pointer) const noexcept {
+    return (pointer != nullptr) ? optional_ref<V &>{*pointer} : optional_ref<V &>{};
+  }
+
+  template <typename V>
+  constexpr optional_ref<V &> operator()(std::optional<V> &optional) const noexcept {
+    return optional;
+  }
+
+  template <typename V>
+  constexpr optional_ref<V const &> operator()(std::optional<V> const &optional) const noexcept {
+    return optional;
+  }
+
+  // A std::optional yielded by value is gone before the ref could be used.
+  template <typename V>
+  void operator()(std::optional<V> &&) const = delete;
+};
+
+}  // namespace detail
+
+// Range adaptors over sequences of optional_ref, composing with std::views.
+// All are lazy, none copies a referent or allocates:
+//
+//   for (auto &value : refs | me_std::views::present | me_std::views::deref) { ... }
+namespace views {
+
+// The present elements of a range of optional_ref or std::optional.
+inline constexpr auto present = std::views::filter(detail::has_value_fn{});
+
+// The referents of a range of present optional_ref, as references.
+inline constexpr auto deref = std::views::transform(detail::deref_fn{});
+
+// A range of pointers or of std::optional lvalues, as optional_ref to their
+// values. Null pointers and empty optionals give empty refs.
+inline constexpr auto as_optional_ref = std::views::transform(detail::as_optional_ref_fn{});
+
+}  // namespace views
+
+}  // namespace me_std
+
+#endif
+
+#endif  // ME_STD_REF_VIEWS_HPP
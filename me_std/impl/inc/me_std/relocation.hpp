@@ -0,0 +1,46 @@
+#ifndef ME_STD_RELOCATION_HPP
+#define ME_STD_RELOCATION_HPP
+
+#include <cstring>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace me_std {
+
+// Whether a T can be moved to another address by copying its bytes, without
+// running its move constructor and destructor. Specialize it for types that
+// hold no pointers into themselves.
+template <typename T>
+struct is_trivially_relocatable : std::is_trivially_copyable<T> {};
+
+// Stateless, but not trivially copyable in every standard library.
+template <typename T>
+struct is_trivially_relocatable<std::allocator<T>> : std::true_type {};
+
+template <typename T>
+constexpr bool is_trivially_relocatable_v = is_trivially_relocatable<T>::value;
+
+// Moves [first, last) to the uninitialized memory at destination and ends the
+// lifetime of the source objects. Returns the end of the destination range.
+template <typename T>
+T *uninitialized_relocate(T *first, T *last, T *destination) noexcept(
+    is_trivially_relocatable_v<T> || std::is_nothrow_move_constructible<T>::value) {
+  if constexpr (is_trivially_relocatable_v<T>) {
+    auto const count = static_cast<std::size_t>(last - first);
+    if (count != 0U) {
+      std::memmove(static_cast<void *>(destination), static_cast<void const *>(first),
+                   count * sizeof(T));
+    }
+    return destination + count;
+  } else {
+    auto *const end = std::uninitialized_move(first, last, destination);
+    std::destroy(first, last);
+    return end;
+  }
+}
+
+}  // namespace me_std
+
+#endif  // ME_STD_RELOCATION_HPP
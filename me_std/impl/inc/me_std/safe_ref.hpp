@@ -2,12 +2,173 @@
 #define ME_STD_SAFE_REF_HPP
 
 #include <cassert>
+#include <cstddef>
+#include <functional>
+#include <me_std/compare_traits.hpp>
+#include <me_std/relocation.hpp>
+#include <me_std/safe_ref_stats.hpp>
 #include <memory>
+#include <optional>
 #include <type_traits>
+#if __has_include(<memory_resource>)
+#include <memory_resource>
+#endif
+#if __has_include(<compare>)
+#include <compare>
+#endif
 
 namespace me_std {
 
+// Where a copied safe_ref keeps its snapshot of the referent.
+enum class safe_ref_storage {
+  heap,           // Every copy allocates its own snapshot.
+  inline_buffer,  // Every copy keeps its own snapshot within the object.
+  shared          // Copies of a snapshot share it through an atomic reference count.
+};
+
+// Decides where a safe_ref keeps its snapshot of a T. Specialize it to tune
+// the inline size for a type or to select another storage mode.
 template <typename T>
+struct safe_ref_storage_traits {
+  static constexpr std::size_t inline_size = 2 * sizeof(void *);
+  static constexpr safe_ref_storage storage =
+      ((sizeof(T) <= inline_size) && std::is_nothrow_copy_constructible<T>::value)
+          ? safe_ref_storage::inline_buffer
+          : safe_ref_storage::heap;
+};
+
+namespace detail {
+
+template <typename T, typename Allocator>
+class safe_ref_heap_snapshot {
+ public:
+  explicit safe_ref_heap_snapshot(Allocator const &allocator)
+      : m_value{nullptr, deleter{allocator}} {}
+
+  T &copy(safe_ref_heap_snapshot const &, T const &value) { return store(value); }
+
+  template <typename V>
+  T &store(V &&value) {
+    Allocator &allocator = m_value.get_deleter();
+    auto *const memory = allocator_traits::allocate(allocator, 1);
+    try {
+      allocator_traits::construct(allocator, memory, std::forward<V>(value));
+    } catch (...) {
+      allocator_traits::deallocate(allocator, memory, 1);
+      throw;
+    }
+    record_safe_ref_allocation<T>(sizeof(T));
+    m_value.reset(memory);
+    return *m_value;
+  }
+
+  // Takes over the snapshot of other, or moves its value into a snapshot of
+  // its own if the allocators differ.
+  void assign(safe_ref_heap_snapshot &&other) {
+    if (get_allocator() == other.get_allocator()) {
+      m_value.reset(other.m_value.release());
+    } else if (other.m_value != nullptr) {
+      store(std::move(*other.m_value));
+    } else {
+      m_value.reset();
+    }
+  }
+
+  // The snapshot, nullptr if there is none.
+  T *get() const noexcept { return m_value.get(); }
+
+  Allocator get_allocator() const noexcept { return m_value.get_deleter(); }
+
+ private:
+  using allocator_traits = std::allocator_traits<Allocator>;
+
+  // Derives from the allocator, so a stateless allocator adds nothing to the size.
+  struct deleter : Allocator {
+    explicit deleter(Allocator const &allocator) : Allocator{allocator} {}
+
+    void operator()(T *value) {
+      allocator_traits::destroy(*this, value);
+      allocator_traits::deallocate(*this, value, 1);
+    }
+  };
+
+  using pointer_type = std::unique_ptr<T, deleter>;
+
+  pointer_type m_value;
+};
+
+// Keeps the allocator only to hand it on to copies, the value itself lives in
+// the object.
+template <typename T, typename Allocator>
+class safe_ref_inline_snapshot : private Allocator {
+ public:
+  explicit safe_ref_inline_snapshot(Allocator const &allocator) : Allocator{allocator} {}
+
+  T &copy(safe_ref_inline_snapshot const &, T const &value) { return m_value.emplace(value); }
+
+  template <typename V>
+  T &store(V &&value) { return m_value.emplace(std::forward<V>(value)); }
+
+  void assign(safe_ref_inline_snapshot &&other) {
+    if (other.m_value.has_value()) {
+      store(std::move(*other.m_value));
+    } else {
+      m_value.reset();
+    }
+  }
+
+  T *get() noexcept { return m_value.has_value() ? &*m_value : nullptr; }
+
+  Allocator get_allocator() const noexcept { return *this; }
+
+ private:
+  std::optional<T> m_value{};
+};
+
+// Snapshots are immutable, so copies of a snapshot may refer to the same one.
+// A copy with a different allocator takes a snapshot of its own.
+template <typename T, typename Allocator>
+class safe_ref_shared_snapshot : private Allocator {
+ public:
+  explicit safe_ref_shared_snapshot(Allocator const &allocator) : Allocator{allocator} {}
+
+  T const &copy(safe_ref_shared_snapshot const &other, T const &value) {
+    if ((other.m_value != nullptr) && (other.get_allocator() == get_allocator())) {
+      m_value = other.m_value;
+    } else {
+      store(value);
+    }
+    return *m_value;
+  }
+
+  template <typename V>
+  T const &store(V &&value) {
+    m_value = std::allocate_shared<T>(get_allocator(), std::forward<V>(value));
+    record_safe_ref_allocation<T>(sizeof(T));
+    return *m_value;
+  }
+
+  void assign(safe_ref_shared_snapshot &&other) {
+    if ((other.m_value == nullptr) || (get_allocator() == other.get_allocator())) {
+      m_value = std::move(other.m_value);
+    } else {
+      store(*other.m_value);
+    }
+  }
+
+  T const *get() const noexcept { return m_value.get(); }
+
+  Allocator get_allocator() const noexcept { return *this; }
+
+  long use_count() const noexcept { return m_value.use_count(); }
+
+ private:
+  std::shared_ptr<T const> m_value{};
+};
+
+}  // namespace detail
+
+template <typename T, typename Allocator = std::allocator<std::decay_t<T>>>
 class safe_ref {
   static_assert(std::is_lvalue_reference<T>::value == true,
                 "Template argument T must be a reference type.");
@@ -15,154 +176,304 @@ class safe_ref {
  public:
   using value_type = std::decay_t<T>;
   using reference_type = T;
+  using allocator_type =
+      typename std::allocator_traits<Allocator>::template rebind_alloc<value_type>;
+
+  // A snapshot reached through a non-const reference can be modified, so it is never shared.
+  static constexpr safe_ref_storage storage =
+      ((safe_ref_storage_traits<value_type>::storage == safe_ref_storage::shared) &&
+       !std::is_const<std::remove_reference_t<T>>::value)
+          ? safe_ref_storage::heap
+          : safe_ref_storage_traits<value_type>::storage;
+
+  safe_ref(reference_type ref, allocator_type const &allocator = allocator_type{})
+      : m_snapshot{allocator}, m_ref{std::addressof(ref)} {}
+
+  // Owns value from the start, as a copy would, without copying it.
+  safe_ref(value_type &&value, allocator_type const &allocator = allocator_type{})
+      : m_snapshot{allocator}, m_ref{std::addressof(m_snapshot.store(std::move(value)))} {}
 
-  safe_ref(reference_type ref) : m_ref{ref} {}
+  // The copy takes its snapshot from the allocator of other, so copies made
+  // within an arena stay in that arena.
+  safe_ref(safe_ref const &other) : safe_ref{other, other.get_allocator()} {}
+  safe_ref(safe_ref const &other, allocator_type const &allocator)
+      : m_snapshot{allocator},
+        m_ref{std::addressof(m_snapshot.copy(other.m_snapshot, *other))} {
+    detail::record_safe_ref_copy<value_type>(sizeof(value_type));
+  }
 
-  safe_ref(safe_ref<T> const &other)
-      : m_store{std::make_unique<value_type>(*other)}, m_ref{*m_store} {}
-  safe_ref<T> &operator=(safe_ref<T> const &) = delete;
+  // Takes over the snapshot of other, or refers to its referent if other has
+  // none. An inline snapshot is moved, the others are not touched. A move never
+  // copies the referent, so a safe_ref moved from one that only refers to its
+  // referent must not outlive that referent either; copy it to keep it alive.
+  safe_ref(safe_ref &&other) noexcept(std::is_nothrow_move_constructible<snapshot_type>::value)
+      : m_snapshot{std::move(other.m_snapshot)},
+        m_ref{(m_snapshot.get() != nullptr) ? m_snapshot.get() : other.m_ref} {}
+
+  // Rebinds to a copy of other, which takes its snapshot from the allocator of
+  // this one. Nothing changes if the copy throws.
+  safe_ref &operator=(safe_ref const &other) {
+    if (this != &other) {
+      *this = safe_ref{other, get_allocator()};
+    }
+    return *this;
+  }
+
+  // Rebinds to the referent of other and takes over its snapshot. With
+  // allocators that compare unequal the snapshot is moved into one of this
+  // allocator instead.
+  safe_ref &operator=(safe_ref &&other) noexcept(
+      std::allocator_traits<allocator_type>::is_always_equal::value &&
+      ((storage != safe_ref_storage::inline_buffer) ||
+       std::is_nothrow_move_constructible<value_type>::value)) {
+    if (this != &other) {
+      m_snapshot.assign(std::move(other.m_snapshot));
+      m_ref = (m_snapshot.get() != nullptr) ? m_snapshot.get() : other.m_ref;
+    }
+    return *this;
+  }
   ~safe_ref() = default;
 
-  reference_type operator*() const noexcept { return m_ref; }
+  reference_type operator*() const noexcept {
+    detail::record_safe_ref_dereference<value_type>();
+    return *m_ref;
+  }
+
+  allocator_type get_allocator() const noexcept { return m_snapshot.get_allocator(); }
+
+  // Number of safe_refs sharing the snapshot, 0 if this one does not own a shared snapshot.
+  template <safe_ref_storage S = storage,
+            typename = std::enable_if_t<S == safe_ref_storage::shared>>
+  long use_count() const noexcept {
+    return m_snapshot.use_count();
+  }
 
-  auto operator==(safe_ref<reference_type> other) const noexcept { return m_ref == other.m_ref; }
-  auto operator<(safe_ref<reference_type> other) const noexcept { return m_ref < other.m_ref; }
+  auto operator==(safe_ref const &other) const noexcept { return *m_ref == *other.m_ref; }
+  auto operator<(safe_ref const &other) const noexcept { return *m_ref < *other.m_ref; }
+
+#if defined(__cpp_lib_three_way_comparison)
+  auto operator<=>(safe_ref const &other) const noexcept
+    requires std::three_way_comparable<value_type>
+  {
+    return *m_ref <=> *other.m_ref;
+  }
+
+  template <typename U>
+  auto operator<=>(U const &other) const noexcept
+    requires detail::is_plain_operand<U> && std::three_way_comparable_with<value_type, U>
+  {
+    return *m_ref <=> other;
+  }
+#endif
 
  private:
-  std::unique_ptr<value_type> m_store{};
-  reference_type m_ref;
+  using snapshot_type = std::conditional_t<
+      storage == safe_ref_storage::inline_buffer,
+      detail::safe_ref_inline_snapshot<value_type, allocator_type>,
+      std::conditional_t<storage == safe_ref_storage::shared,
+                         detail::safe_ref_shared_snapshot<value_type, allocator_type>,
+                         detail::safe_ref_heap_snapshot<value_type, allocator_type>>>;
+
+  snapshot_type m_snapshot;
+  std::remove_reference_t<reference_type> *m_ref;
 };
 
-template <typename T>
-bool operator==(T const &lhs, safe_ref<T &> rhs) {
-  return (lhs == *rhs);
-}
+// An inline snapshot is referred to from within the safe_ref, so only heap and
+// shared storage allow to relocate a safe_ref by its bytes.
+template <typename T, typename Allocator>
+struct is_trivially_relocatable<safe_ref<T, Allocator>>
+    : std::integral_constant<
+          bool, (safe_ref<T, Allocator>::storage != safe_ref_storage::inline_buffer) &&
+                    is_trivially_relocatable<
+                        typename safe_ref<T, Allocator>::allocator_type>::value> {};
 
+#if __has_include(<memory_resource>)
+namespace pmr {
 template <typename T>
-bool operator==(T const &lhs, safe_ref<T const &> rhs) {
+using safe_ref = me_std::safe_ref<T, std::pmr::polymorphic_allocator<std::decay_t<T>>>;
+}  // namespace pmr
+#endif
+
+namespace detail {
+
+template <typename T, typename A>
+struct is_ref_wrapper<safe_ref<T, A>> : std::true_type {};
+
+}  // namespace detail
+
+// Any U comparable with the referent is compared with it directly, see
+// optional_ref.
+
+template <typename T, typename A, typename U,
+          typename = detail::enable_if_ref_equality_comparable<T, U>>
+bool operator==(U const &lhs, safe_ref<T, A> const &rhs) {
   return (lhs == *rhs);
 }
 
-template <typename T>
-bool operator==(safe_ref<T &> lhs, T const &rhs) {
+template <typename T, typename A, typename U,
+          typename = detail::enable_if_ref_equality_comparable<T, U>>
+bool operator==(safe_ref<T, A> const &lhs, U const &rhs) {
   return (*lhs == rhs);
 }
 
-template <typename T>
-bool operator==(safe_ref<T const &> lhs, T const &rhs) {
-  return (*lhs == rhs);
+template <typename T, typename A, typename U,
+          typename = detail::enable_if_ref_less_comparable<T, U>>
+bool operator<(U const &lhs, safe_ref<T, A> const &rhs) {
+  return (lhs < *rhs);
 }
 
-template <typename T>
-bool operator<(T const &lhs, safe_ref<T &> rhs) {
-  return (lhs < *rhs);
+template <typename T, typename A, typename U,
+          typename = detail::enable_if_ref_less_comparable<T, U>>
+bool operator<(safe_ref<T, A> const &lhs, U const &rhs) {
+  return (*lhs < rhs);
 }
-template <typename T>
-bool operator<(T const &lhs, safe_ref<T const &> rhs) {
-  return (lhs < *rhs);
+
+template <typename T, typename A>
+bool operator!=(safe_ref<T, A> const &lhs, safe_ref<T, A> const &rhs) {
+  return !(*lhs == *rhs);
 }
 
-template <typename T>
-bool operator<(safe_ref<T &> lhs, T const &rhs) {
-  return (*lhs < rhs);
+template <typename T, typename A, typename U,
+          typename = detail::enable_if_ref_equality_comparable<T, U>>
+bool operator!=(U const &lhs, safe_ref<T, A> const &rhs) {
+  return !(lhs == *rhs);
 }
-template <typename T>
-bool operator<(safe_ref<T const &> lhs, T const &rhs) {
-  return (*lhs < rhs);
+
+template <typename T, typename A, typename U,
+          typename = detail::enable_if_ref_equality_comparable<T, U>>
+bool operator!=(safe_ref<T, A> const &lhs, U const &rhs) {
+  return !(*lhs == rhs);
 }
 
-template <typename T>
-bool operator!=(safe_ref<T> lhs, safe_ref<T> rhs) {
-  return !(lhs == rhs);
+template <typename T, typename A>
+bool operator<=(safe_ref<T, A> const &lhs, safe_ref<T, A> const &rhs) {
+  return !(*rhs < *lhs);
 }
 
-template <typename T>
-bool operator!=(T const &lhs, safe_ref<T &> rhs) {
-  return !(lhs == rhs);
+template <typename T, typename A, typename U,
+          typename = detail::enable_if_ref_less_comparable<T, U>>
+bool operator<=(U const &lhs, safe_ref<T, A> const &rhs) {
+  return !(*rhs < lhs);
 }
-template <typename T>
-bool operator!=(T const &lhs, safe_ref<T const &> rhs) {
-  return !(lhs == rhs);
+
+template <typename T, typename A, typename U,
+          typename = detail::enable_if_ref_less_comparable<T, U>>
+bool operator<=(safe_ref<T, A> const &lhs, U const &rhs) {
+  return !(rhs < *lhs);
 }
 
-template <typename T>
-bool operator!=(safe_ref<T &> lhs, T const &rhs) {
-  return !(lhs == rhs);
+template <typename T, typename A>
+bool operator>(safe_ref<T, A> const &lhs, safe_ref<T, A> const &rhs) {
+  return (*rhs < *lhs);
 }
-template <typename T>
-bool operator!=(safe_ref<T const &> lhs, T const &rhs) {
-  return !(lhs == rhs);
+
+template <typename T, typename A, typename U,
+          typename = detail::enable_if_ref_less_comparable<T, U>>
+bool operator>(U const &lhs, safe_ref<T, A> const &rhs) {
+  return (*rhs < lhs);
 }
 
-template <typename T>
-bool operator<=(safe_ref<T> lhs, safe_ref<T> rhs) {
-  return (lhs == rhs) || (lhs < rhs);
+template <typename T, typename A, typename U,
+          typename = detail::enable_if_ref_less_comparable<T, U>>
+bool operator>(safe_ref<T, A> const &lhs, U const &rhs) {
+  return (rhs < *lhs);
 }
 
-template <typename T>
-bool operator<=(T const &lhs, safe_ref<T &> rhs) {
-  return (lhs == rhs) || (lhs < rhs);
+template <typename T, typename A>
+bool operator>=(safe_ref<T, A> const &lhs, safe_ref<T, A> const &rhs) {
+  return !(*lhs < *rhs);
 }
-template <typename T>
-bool operator<=(T const &lhs, safe_ref<T const &> rhs) {
-  return (lhs == rhs) || (lhs < rhs);
+
+template <typename T, typename A, typename U,
+          typename = detail::enable_if_ref_less_comparable<T, U>>
+bool operator>=(U const &lhs, safe_ref<T, A> const &rhs) {
+  return !(lhs < *rhs);
 }
 
-template <typename T>
-bool operator<=(safe_ref<T &> lhs, T const &rhs) {
-  return (lhs == rhs) || (lhs < rhs);
+template <typename T, typename A, typename U,
+          typename = detail::enable_if_ref_less_comparable<T, U>>
+bool operator>=(safe_ref<T, A> const &lhs, U const &rhs) {
+  return !(*lhs < rhs);
 }
-template <typename T>
-bool operator<=(safe_ref<T const &> lhs, T const &rhs) {
-  return (lhs == rhs) || (lhs < rhs);
+
+// A safe_ref always has a value, so it is greater than an empty std::optional.
+
+template <typename T, typename A, typename U,
+          typename = detail::enable_if_optional_equality_comparable<T, U>>
+bool operator==(safe_ref<T, A> const &lhs, std::optional<U> const &rhs) {
+  return rhs.has_value() && (*lhs == *rhs);
 }
 
-template <typename T>
-bool operator>(safe_ref<T> lhs, safe_ref<T> rhs) {
-  return !(lhs <= rhs);
+template <typename T, typename A, typename U,
+          typename = detail::enable_if_optional_equality_comparable<T, U>>
+bool operator==(std::optional<U> const &lhs, safe_ref<T, A> const &rhs) {
+  return lhs.has_value() && (*lhs == *rhs);
 }
 
-template <typename T>
-bool operator>(T const &lhs, safe_ref<T &> rhs) {
-  return !(lhs <= rhs);
+template <typename T, typename A, typename U,
+          typename = detail::enable_if_optional_equality_comparable<T, U>>
+bool operator!=(safe_ref<T, A> const &lhs, std::optional<U> const &rhs) {
+  return !(lhs == rhs);
 }
-template <typename T>
-bool operator>(T const &lhs, safe_ref<T const &> rhs) {
-  return !(lhs <= rhs);
+
+template <typename T, typename A, typename U,
+          typename = detail::enable_if_optional_equality_comparable<T, U>>
+bool operator!=(std::optional<U> const &lhs, safe_ref<T, A> const &rhs) {
+  return !(lhs == rhs);
 }
 
-template <typename T>
-bool operator>(safe_ref<T &> lhs, T const &rhs) {
-  return !(lhs <= rhs);
+template <typename T, typename A, typename U, typename = detail::enable_if_optional_ordered<T, U>>
+bool operator<(safe_ref<T, A> const &lhs, std::optional<U> const &rhs) {
+  return rhs.has_value() && (*lhs < *rhs);
 }
-template <typename T>
-bool operator>(safe_ref<T const &> lhs, T const &rhs) {
-  return !(lhs <= rhs);
+
+template <typename T, typename A, typename U, typename = detail::enable_if_optional_ordered<T, U>>
+bool operator<(std::optional<U> const &lhs, safe_ref<T, A> const &rhs) {
+  return !lhs.has_value() || (*lhs < *rhs);
 }
 
-template <typename T>
-bool operator>=(safe_ref<T> lhs, safe_ref<T> rhs) {
-  return (lhs == rhs) || (lhs > rhs);
+template <typename T, typename A, typename U, typename = detail::enable_if_optional_ordered<T, U>>
+bool operator<=(safe_ref<T, A> const &lhs, std::optional<U> const &rhs) {
+  return !(rhs < lhs);
 }
 
-template <typename T>
-bool operator>=(T const &lhs, safe_ref<T &> rhs) {
-  return (lhs == rhs) || (lhs > rhs);
+template <typename T, typename A, typename U, typename = detail::enable_if_optional_ordered<T, U>>
+bool operator<=(std::optional<U> const &lhs, safe_ref<T, A> const &rhs) {
+  return !(rhs < lhs);
 }
-template <typename T>
-bool operator>=(T const &lhs, safe_ref<T const &> rhs) {
-  return (lhs == rhs) || (lhs > rhs);
+
+template <typename T, typename A, typename U, typename = detail::enable_if_optional_ordered<T, U>>
+bool operator>(safe_ref<T, A> const &lhs, std::optional<U> const &rhs) {
+  return (rhs < lhs);
 }
 
-template <typename T>
-bool operator>=(safe_ref<T &> lhs, T const &rhs) {
-  return (lhs == rhs) || (lhs > rhs);
+template <typename T, typename A, typename U, typename = detail::enable_if_optional_ordered<T, U>>
+bool operator>(std::optional<U> const &lhs, safe_ref<T, A> const &rhs) {
+  return (rhs < lhs);
 }
-template <typename T>
-bool operator>=(safe_ref<T const &> lhs, T const &rhs) {
-  return (lhs == rhs) || (lhs > rhs);
+
+template <typename T, typename A, typename U, typename = detail::enable_if_optional_ordered<T, U>>
+bool operator>=(safe_ref<T, A> const &lhs, std::optional<U> const &rhs) {
+  return !(lhs < rhs);
+}
+
+template <typename T, typename A, typename U, typename = detail::enable_if_optional_ordered<T, U>>
+bool operator>=(std::optional<U> const &lhs, safe_ref<T, A> const &rhs) {
+  return !(lhs < rhs);
 }
 
 }  // namespace me_std
 
+namespace std {
+
+template <typename T, typename Allocator>
+struct hash<me_std::safe_ref<T, Allocator>> {
+  std::size_t operator()(me_std::safe_ref<T, Allocator> const &ref) const
+      noexcept(noexcept(std::hash<std::decay_t<T>>{}(*ref))) {
+    return std::hash<std::decay_t<T>>{}(*ref);
+  }
+};
+
+}  // namespace std
+
 #endif  // ME_STD_SAFE_REF_HPP
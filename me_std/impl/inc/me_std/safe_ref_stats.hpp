@@ -0,0 +1,327 @@
+#ifndef ME_STD_SAFE_REF_STATS_HPP
+#define ME_STD_SAFE_REF_STATS_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+#if defined(ME_STD_SAFE_REF_STATS)
+#include <algorithm>
+#include <atomic>
+#include <map>
+#include <mutex>
+#include <typeindex>
+#include <typeinfo>
+#if __has_include(<execinfo.h>)
+#include <execinfo.h>
+#define ME_STD_SAFE_REF_STACKS 1
+#endif
+#endif
+
+// Defining ME_STD_SAFE_REF_STATS for a whole program makes every safe_ref
+// count its copies, snapshot allocations and dereferences per referent type.
+// Without it the counting hooks are empty and the query functions report
+// nothing.
+
+namespace me_std {
+
+// Totals of all threads for one referent type.
+struct safe_ref_stats {
+  std::string type_name{};
+  std::uint64_t copies{0};
+  std::uint64_t allocations{0};  // Snapshots placed on the heap, see safe_ref_storage.
+  std::uint64_t bytes{0};        // Size of those snapshots.
+  std::uint64_t dereferences{0};
+};
+
+// The copies made from one call stack among the sampled copies.
+struct safe_ref_stack_sample {
+  std::uint64_t stack_id{0};
+  std::string type_name{};
+  std::uint64_t copies{0};
+  std::uint64_t bytes{0};
+  std::vector<void *> frames{};  // Innermost first, for backtrace_symbols or addr2line.
+};
+
+namespace detail {
+
+#if defined(ME_STD_SAFE_REF_STATS)
+
+// Written by their own thread only, atomic so a snapshot may read them meanwhile.
+struct safe_ref_counters {
+  std::atomic<std::uint64_t> copies{0};
+  std::atomic<std::uint64_t> allocations{0};
+  std::atomic<std::uint64_t> bytes{0};
+  std::atomic<std::uint64_t> dereferences{0};
+
+  void add_to(safe_ref_stats &stats) const noexcept {
+    stats.copies += copies.load(std::memory_order_relaxed);
+    stats.allocations += allocations.load(std::memory_order_relaxed);
+    stats.bytes += bytes.load(std::memory_order_relaxed);
+    stats.dereferences += dereferences.load(std::memory_order_relaxed);
+  }
+
+  void reset() noexcept {
+    copies.store(0, std::memory_order_relaxed);
+    allocations.store(0, std::memory_order_relaxed);
+    bytes.store(0, std::memory_order_relaxed);
+    dereferences.store(0, std::memory_order_relaxed);
+  }
+};
+
+// The counters of every thread per referent type. A thread that exits hands
+// its counts on to the totals of the exited threads.
+class safe_ref_stats_registry {
+ public:
+  static safe_ref_stats_registry &instance() {
+    static safe_ref_stats_registry registry{};
+    return registry;
+  }
+
+  void add(std::type_info const &type, safe_ref_counters *counters) {
+    std::lock_guard<std::mutex> const lock{m_mutex};
+    auto &entry = m_types[std::type_index{type}];
+    entry.totals.type_name = type.name();
+    entry.live.push_back(counters);
+  }
+
+  // Only for added counters, so it allocates nothing.
+  void remove(std::type_info const &type, safe_ref_counters *counters) {
+    std::lock_guard<std::mutex> const lock{m_mutex};
+    auto &entry = m_types.find(std::type_index{type})->second;
+    counters->add_to(entry.totals);
+    entry.live.erase(std::remove(entry.live.begin(), entry.live.end(), counters),
+                     entry.live.end());
+  }
+
+  std::vector<safe_ref_stats> snapshot() const {
+    std::lock_guard<std::mutex> const lock{m_mutex};
+    std::vector<safe_ref_stats> result{};
+    result.reserve(m_types.size());
+    for (auto const &type : m_types) {
+      result.push_back(totals(type.second));
+    }
+    return result;
+  }
+
+  safe_ref_stats snapshot(std::type_info const &type) const {
+    std::lock_guard<std::mutex> const lock{m_mutex};
+    auto const entry = m_types.find(std::type_index{type});
+    if (entry == m_types.end()) {
+      return safe_ref_stats{type.name()};
+    }
+    return totals(entry->second);
+  }
+
+  void reset() {
+    std::lock_guard<std::mutex> const lock{m_mutex};
+    for (auto &type : m_types) {
+      type.second.totals = safe_ref_stats{type.second.totals.type_name};
+      for (auto *const counters : type.second.live) {
+        counters->reset();
+      }
+    }
+    m_stacks.clear();
+  }
+
+  void set_sampling(std::uint32_t every_nth_copy) noexcept {
+    m_sampling.store(every_nth_copy, std::memory_order_relaxed);
+  }
+
+  std::uint32_t sampling() const noexcept { return m_sampling.load(std::memory_order_relaxed); }
+
+  void add_sample(std::type_info const &type, std::size_t bytes, void *const *frames,
+                  std::size_t frame_count) {
+    // FNV-1a over the return addresses.
+    std::uint64_t stack_id = 14695981039346656037ULL;
+    for (std::size_t frame = 0; frame < frame_count; ++frame) {
+      stack_id = (stack_id ^ reinterpret_cast<std::uintptr_t>(frames[frame])) * 1099511628211ULL;
+    }
+
+    std::lock_guard<std::mutex> const lock{m_mutex};
+    auto &sample = m_stacks[stack_id];
+    if (sample.copies == 0) {
+      sample.stack_id = stack_id;
+      sample.type_name = type.name();
+      sample.frames.assign(frames, frames + frame_count);
+    }
+    ++sample.copies;
+    sample.bytes += bytes;
+  }
+
+  std::vector<safe_ref_stack_sample> samples() const {
+    std::lock_guard<std::mutex> const lock{m_mutex};
+    std::vector<safe_ref_stack_sample> result{};
+    result.reserve(m_stacks.size());
+    for (auto const &stack : m_stacks) {
+      result.push_back(stack.second);
+    }
+    std::sort(result.begin(), result.end(), [](auto const &lhs, auto const &rhs) {
+      return (lhs.copies != rhs.copies) ? (lhs.copies > rhs.copies) : (lhs.bytes > rhs.bytes);
+    });
+    return result;
+  }
+
+ private:
+  struct type_entry {
+    safe_ref_stats totals{};  // Of the exited threads.
+    std::vector<safe_ref_counters *> live{};
+  };
+
+  safe_ref_stats_registry() = default;
+
+  static safe_ref_stats totals(type_entry const &entry) {
+    auto result = entry.totals;
+    for (auto const *const counters : entry.live) {
+      counters->add_to(result);
+    }
+    return result;
+  }
+
+  mutable std::mutex m_mutex{};
+  std::map<std::type_index, type_entry> m_types{};
+  std::map<std::uint64_t, safe_ref_stack_sample> m_stacks{};
+  std::atomic<std::uint32_t> m_sampling{0};
+};
+
+// Constructed on the first use by a thread, which may be a noexcept
+// dereference. If registering fails for lack of memory, the thread still
+// counts, but its counts for this type are not reported.
+class safe_ref_thread_counters {
+ public:
+  explicit safe_ref_thread_counters(std::type_info const &type) noexcept : m_type{type} {
+    try {
+      safe_ref_stats_registry::instance().add(m_type, &m_counters);
+      m_registered = true;
+    } catch (...) {
+    }
+  }
+  ~safe_ref_thread_counters() {
+    if (m_registered) {
+      safe_ref_stats_registry::instance().remove(m_type, &m_counters);
+    }
+  }
+
+  safe_ref_thread_counters(safe_ref_thread_counters const &) = delete;
+  safe_ref_thread_counters &operator=(safe_ref_thread_counters const &) = delete;
+
+  safe_ref_counters &counters() noexcept { return m_counters; }
+
+ private:
+  std::type_info const &m_type;
+  safe_ref_counters m_counters{};
+  bool m_registered{false};
+};
+
+template <typename T>
+safe_ref_counters &safe_ref_counters_of() noexcept {
+  thread_local safe_ref_thread_counters counters{typeid(T)};
+  return counters.counters();
+}
+
+inline void sample_safe_ref_copy(std::type_info const &type, std::size_t bytes) {
+#if defined(ME_STD_SAFE_REF_STACKS)
+  auto &registry = safe_ref_stats_registry::instance();
+  auto const every_nth_copy = registry.sampling();
+  if (every_nth_copy == 0) {
+    return;
+  }
+  thread_local std::uint32_t countdown{0};
+  if (countdown > 1) {
+    --countdown;
+    return;
+  }
+  countdown = every_nth_copy;
+
+  constexpr int max_frames = 32;
+  void *frames[max_frames];
+  auto const frame_count = ::backtrace(frames, max_frames);
+  registry.add_sample(type, bytes, frames, static_cast<std::size_t>(frame_count));
+#else
+  static_cast<void>(type);
+  static_cast<void>(bytes);
+#endif
+}
+
+#endif
+
+// Hooks of safe_ref, empty unless ME_STD_SAFE_REF_STATS is defined.
+
+template <typename T>
+inline void record_safe_ref_copy(std::size_t bytes) {
+#if defined(ME_STD_SAFE_REF_STATS)
+  safe_ref_counters_of<T>().copies.fetch_add(1, std::memory_order_relaxed);
+  sample_safe_ref_copy(typeid(T), bytes);
+#else
+  static_cast<void>(bytes);
+#endif
+}
+
+template <typename T>
+inline void record_safe_ref_allocation(std::size_t bytes) {
+#if defined(ME_STD_SAFE_REF_STATS)
+  auto &counters = safe_ref_counters_of<T>();
+  counters.allocations.fetch_add(1, std::memory_order_relaxed);
+  counters.bytes.fetch_add(bytes, std::memory_order_relaxed);
+#else
+  static_cast<void>(bytes);
+#endif
+}
+
+template <typename T>
+inline void record_safe_ref_dereference() noexcept {
+#if defined(ME_STD_SAFE_REF_STATS)
+  safe_ref_counters_of<T>().dereferences.fetch_add(1, std::memory_order_relaxed);
+#endif
+}
+
+}  // namespace detail
+
+// Totals of every referent type a safe_ref was used with, in no particular order.
+inline std::vector<safe_ref_stats> safe_ref_stats_snapshot() {
+#if defined(ME_STD_SAFE_REF_STATS)
+  return detail::safe_ref_stats_registry::instance().snapshot();
+#else
+  return {};
+#endif
+}
+
+// Totals of safe_refs to T.
+template <typename T>
+safe_ref_stats safe_ref_stats_of() {
+#if defined(ME_STD_SAFE_REF_STATS)
+  return detail::safe_ref_stats_registry::instance().snapshot(typeid(std::decay_t<T>));
+#else
+  return {};
+#endif
+}
+
+// Zeroes all counters and drops the stack samples.
+inline void safe_ref_stats_reset() {
+#if defined(ME_STD_SAFE_REF_STATS)
+  detail::safe_ref_stats_registry::instance().reset();
+#endif
+}
+
+// Captures the call stack of every nth copy of a safe_ref on each thread, 0
+// turns sampling off. Stacks are only available where <execinfo.h> is.
+inline void set_safe_ref_stack_sampling(std::uint32_t every_nth_copy) noexcept {
+#if defined(ME_STD_SAFE_REF_STATS)
+  detail::safe_ref_stats_registry::instance().set_sampling(every_nth_copy);
+#else
+  static_cast<void>(every_nth_copy);
+#endif
+}
+
+// The sampled call stacks, the one that copied most first.
+inline std::vector<safe_ref_stack_sample> safe_ref_stack_samples() {
+#if defined(ME_STD_SAFE_REF_STATS)
+  return detail::safe_ref_stats_registry::instance().samples();
+#else
+  return {};
+#endif
+}
+
+}  // namespace me_std
+
+#endif  // ME_STD_SAFE_REF_STATS_HPP
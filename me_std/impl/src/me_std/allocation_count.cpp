@@ -0,0 +1,92 @@
+#include "allocation_count.hpp"
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+// All forms of the global operator new and delete are replaced, so memory the
+// library allocates with one form and frees with another still pairs malloc
+// with free.
+
+namespace {
+
+std::atomic<std::size_t> allocations{0};
+
+void *allocate(std::size_t size) noexcept {
+  allocations.fetch_add(1, std::memory_order_relaxed);
+  return std::malloc(size == 0 ? 1 : size);
+}
+
+void *allocate(std::size_t size, std::align_val_t alignment) noexcept {
+  allocations.fetch_add(1, std::memory_order_relaxed);
+  auto const align = static_cast<std::size_t>(alignment);
+  // aligned_alloc wants a size that is a multiple of the alignment.
+  auto const rounded = ((size == 0 ? 1 : size) + align - 1) / align * align;
+  return std::aligned_alloc(align, rounded);
+}
+
+}  // namespace
+
+namespace me_std::test {
+
+std::size_t allocation_count() noexcept { return allocations.load(std::memory_order_relaxed); }
+
+}  // namespace me_std::test
+
+void *operator new(std::size_t size) {
+  if (void *memory = allocate(size)) {
+    return memory;
+  }
+  throw std::bad_alloc{};
+}
+
+void *operator new[](std::size_t size) {
+  if (void *memory = allocate(size)) {
+    return memory;
+  }
+  throw std::bad_alloc{};
+}
+
+void *operator new(std::size_t size, std::align_val_t alignment) {
+  if (void *memory = allocate(size, alignment)) {
+    return memory;
+  }
+  throw std::bad_alloc{};
+}
+
+void *operator new[](std::size_t size, std::align_val_t alignment) {
+  if (void *memory = allocate(size, alignment)) {
+    return memory;
+  }
+  throw std::bad_alloc{};
+}
+
+void *operator new(std::size_t size, std::nothrow_t const &) noexcept { return allocate(size); }
+
+void *operator new[](std::size_t size, std::nothrow_t const &) noexcept { return allocate(size); }
+
+void *operator new(std::size_t size, std::align_val_t alignment, std::nothrow_t const &) noexcept {
+  return allocate(size, alignment);
+}
+
+void *operator new[](std::size_t size, std::align_val_t alignment,
+                     std::nothrow_t const &) noexcept {
+  return allocate(size, alignment);
+}
+
+void operator delete(void *memory) noexcept { std::free(memory); }
+void operator delete[](void *memory) noexcept { std::free(memory); }
+void operator delete(void *memory, std::size_t) noexcept { std::free(memory); }
+void operator delete[](void *memory, std::size_t) noexcept { std::free(memory); }
+void operator delete(void *memory, std::align_val_t) noexcept { std::free(memory); }
+void operator delete[](void *memory, std::align_val_t) noexcept { std::free(memory); }
+void operator delete(void *memory, std::size_t, std::align_val_t) noexcept { std::free(memory); }
+void operator delete[](void *memory, std::size_t, std::align_val_t) noexcept { std::free(memory); }
+void operator delete(void *memory, std::nothrow_t const &) noexcept { std::free(memory); }
+void operator delete[](void *memory, std::nothrow_t const &) noexcept { std::free(memory); }
+void operator delete(void *memory, std::align_val_t, std::nothrow_t const &) noexcept {
+  std::free(memory);
+}
+void operator delete[](void *memory, std::align_val_t, std::nothrow_t const &) noexcept {
+  std::free(memory);
+}
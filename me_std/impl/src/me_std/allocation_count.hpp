@@ -0,0 +1,13 @@
+#ifndef ME_STD_ALLOCATION_COUNT_HPP
+#define ME_STD_ALLOCATION_COUNT_HPP
+
+#include <cstddef>
+
+namespace me_std::test {
+
+// Number of calls to the replaced global operator new since program start.
+std::size_t allocation_count() noexcept;
+
+}  // namespace me_std::test
+
+#endif  // ME_STD_ALLOCATION_COUNT_HPP
@@ -0,0 +1,49 @@
+#include <me_std/atomic_optional_ref.hpp>
+#include <mutex>
+#include <string>
+
+#include "benchmark_support.hpp"
+
+namespace {
+using namespace me_std::bench;
+
+struct config {
+  std::string name{"service"};
+  int limit{64};
+};
+
+config const current_config{};
+
+// The guarded read the atomic ref replaces.
+std::mutex config_mutex{};
+config const *locked_config{&current_config};
+
+void mutex_read(benchmark::State &state) {
+  for (auto _ : state) {
+    std::lock_guard<std::mutex> const lock{config_mutex};
+    benchmark::DoNotOptimize(locked_config->limit);
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(mutex_read)->ThreadRange(1, 64)->UseRealTime();
+
+me_std::atomic_optional_ref<config const &> atomic_config{current_config};
+
+void atomic_load(benchmark::State &state) {
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(atomic_config.load(std::memory_order_acquire)->limit);
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(atomic_load)->ThreadRange(1, 64)->UseRealTime();
+
+void atomic_protect(benchmark::State &state) {
+  for (auto _ : state) {
+    auto const guard = atomic_config.protect();
+    benchmark::DoNotOptimize(guard->limit);
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(atomic_protect)->ThreadRange(1, 64)->UseRealTime();
+
+}  // namespace
@@ -0,0 +1,59 @@
+#include <me_std/deferred_ref.hpp>
+#include <me_std/safe_ref.hpp>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "benchmark_support.hpp"
+
+namespace {
+using namespace me_std::bench;
+
+// A copy while the referent lives, the common case the deferred copy is for.
+void copy_safe_ref(benchmark::State &state) {
+  std::string const value(64, 'a');
+  me_std::safe_ref<std::string const &> const source{value};
+  allocation_counter const allocations{state};
+  for (auto _ : state) {
+    me_std::safe_ref<std::string const &> const copied{source};
+    benchmark::DoNotOptimize(&copied);
+  }
+}
+BENCHMARK(copy_safe_ref);
+
+template <me_std::ref_threading Threading>
+void copy_deferred_ref(benchmark::State &state) {
+  me_std::ref_source<std::string, Threading> const value{std::string(64, 'a')};
+  me_std::deferred_ref<std::string const &, Threading> const source{value};
+  allocation_counter const allocations{state};
+  for (auto _ : state) {
+    me_std::deferred_ref<std::string const &, Threading> const copied{source};
+    benchmark::DoNotOptimize(&copied);
+  }
+}
+BENCHMARK(copy_deferred_ref<me_std::ref_threading::single_threaded>);
+BENCHMARK(copy_deferred_ref<me_std::ref_threading::thread_safe>);
+
+// The rare case: the source goes away under state.range(0) borrowers.
+template <me_std::ref_threading Threading>
+void detach_deferred_refs(benchmark::State &state) {
+  using ref_type = me_std::deferred_ref<std::string const &, Threading>;
+  std::vector<std::optional<ref_type>> borrowers(static_cast<std::size_t>(state.range(0)));
+  allocation_counter const allocations{state};
+  for (auto _ : state) {
+    {
+      me_std::ref_source<std::string, Threading> const value{std::string(64, 'a')};
+      for (auto &borrower : borrowers) {
+        borrower.emplace(value);
+      }
+    }
+    benchmark::DoNotOptimize(&*borrowers.front());
+    for (auto &borrower : borrowers) {
+      borrower.reset();
+    }
+  }
+}
+BENCHMARK(detach_deferred_refs<me_std::ref_threading::single_threaded>)->Arg(8);
+BENCHMARK(detach_deferred_refs<me_std::ref_threading::thread_safe>)->Arg(8);
+
+}  // namespace
@@ -0,0 +1,125 @@
+#include <algorithm>
+#include <functional>
+#include <map>
+#include <me_std/find_ref.hpp>
+#include <me_std/optional_ref.hpp>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "benchmark_support.hpp"
+
+namespace {
+using namespace me_std::bench;
+
+constexpr int entries = 1024;
+
+std::map<std::string, int, std::less<>> make_map() {
+  std::map<std::string, int, std::less<>> map{};
+  for (int key = 0; key < entries; ++key) {
+    map.emplace(std::to_string(key * 7919), key);
+  }
+  return map;
+}
+
+std::vector<std::string> make_keys() {
+  std::vector<std::string> keys{};
+  for (int key = 0; key < entries; ++key) {
+    keys.push_back(std::to_string(((key * 37) % entries) * 7919));
+  }
+  return keys;
+}
+
+// The hand-written lookup find_ref replaces.
+void map_find_by_hand(benchmark::State &state) {
+  auto const map = make_map();
+  auto const keys = make_keys();
+  std::size_t index{0};
+  allocation_counter const allocations{state};
+  for (auto _ : state) {
+    auto const found = map.find(std::string_view{keys[index++ % keys.size()]});
+    me_std::optional_ref<int const &> const ref =
+        (found != map.end()) ? me_std::optional_ref<int const &>{found->second}
+                             : me_std::optional_ref<int const &>{};
+    benchmark::DoNotOptimize(ref);
+  }
+}
+BENCHMARK(map_find_by_hand);
+
+void map_find_ref(benchmark::State &state) {
+  auto const map = make_map();
+  auto const keys = make_keys();
+  std::size_t index{0};
+  allocation_counter const allocations{state};
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(
+        me_std::find_ref(map, std::string_view{keys[index++ % keys.size()]}));
+  }
+}
+BENCHMARK(map_find_ref);
+
+void unordered_map_find_by_hand(benchmark::State &state) {
+  std::unordered_map<int, int> map{};
+  for (int key = 0; key < entries; ++key) {
+    map.emplace(key * 7919, key);
+  }
+  int key{0};
+  allocation_counter const allocations{state};
+  for (auto _ : state) {
+    auto const found = map.find((key++ % entries) * 7919);
+    me_std::optional_ref<int const &> const ref =
+        (found != map.end()) ? me_std::optional_ref<int const &>{found->second}
+                             : me_std::optional_ref<int const &>{};
+    benchmark::DoNotOptimize(ref);
+  }
+}
+BENCHMARK(unordered_map_find_by_hand);
+
+void unordered_map_find_ref(benchmark::State &state) {
+  std::unordered_map<int, int> map{};
+  for (int key = 0; key < entries; ++key) {
+    map.emplace(key * 7919, key);
+  }
+  int key{0};
+  allocation_counter const allocations{state};
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(me_std::find_ref(std::as_const(map), (key++ % entries) * 7919));
+  }
+}
+BENCHMARK(unordered_map_find_ref);
+
+void sorted_vector_find_by_hand(benchmark::State &state) {
+  std::vector<int> values(entries);
+  for (int value = 0; value < entries; ++value) {
+    values[static_cast<std::size_t>(value)] = value * 2;
+  }
+  int key{0};
+  allocation_counter const allocations{state};
+  for (auto _ : state) {
+    auto const wanted = key++ % (2 * entries);
+    auto const found = std::lower_bound(values.cbegin(), values.cend(), wanted);
+    me_std::optional_ref<int const &> const ref =
+        ((found != values.cend()) && !(wanted < *found))
+            ? me_std::optional_ref<int const &>{*found}
+            : me_std::optional_ref<int const &>{};
+    benchmark::DoNotOptimize(ref);
+  }
+}
+BENCHMARK(sorted_vector_find_by_hand);
+
+void sorted_vector_find_ref(benchmark::State &state) {
+  std::vector<int> values(entries);
+  for (int value = 0; value < entries; ++value) {
+    values[static_cast<std::size_t>(value)] = value * 2;
+  }
+  int key{0};
+  allocation_counter const allocations{state};
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(
+        me_std::find_ref(me_std::sorted, std::as_const(values), key++ % (2 * entries)));
+  }
+}
+BENCHMARK(sorted_vector_find_ref);
+
+}  // namespace
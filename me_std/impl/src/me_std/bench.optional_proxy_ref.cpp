@@ -0,0 +1,60 @@
+#include <me_std/optional_proxy_ref.hpp>
+#include <me_std/optional_ref.hpp>
+#include <vector>
+
+#include "benchmark_support.hpp"
+
+namespace {
+using namespace me_std::bench;
+
+constexpr std::size_t entries = 4096;
+
+// Plain references through the accessor, to be on par with optional_ref.
+void sum_optional_ref(benchmark::State &state) {
+  std::vector<int> const values(entries, 1);
+  std::vector<me_std::optional_ref<int const &>> const refs(values.cbegin(), values.cend());
+  allocation_counter const allocations{state};
+  for (auto _ : state) {
+    int sum{0};
+    for (auto ref : refs) {
+      sum += ref.value_or(0);
+    }
+    benchmark::DoNotOptimize(sum);
+  }
+}
+BENCHMARK(sum_optional_ref);
+
+void sum_optional_proxy_ref(benchmark::State &state) {
+  using ref_type = me_std::optional_proxy_ref<me_std::reference_accessor<int const &>>;
+  std::vector<int> const values(entries, 1);
+  std::vector<ref_type> const refs(values.cbegin(), values.cend());
+  allocation_counter const allocations{state};
+  for (auto _ : state) {
+    int sum{0};
+    for (auto ref : refs) {
+      sum += ref.value_or(0);
+    }
+    benchmark::DoNotOptimize(sum);
+  }
+}
+BENCHMARK(sum_optional_proxy_ref);
+
+// Bits kept packed, one bit per flag instead of a byte.
+void count_packed_bits(benchmark::State &state) {
+  std::vector<bool> bits(entries, true);
+  std::vector<me_std::optional_element_ref<std::vector<bool>>> refs{};
+  for (std::size_t index = 0U; index < entries; ++index) {
+    refs.emplace_back(bits, index);
+  }
+  allocation_counter const allocations{state};
+  for (auto _ : state) {
+    int count{0};
+    for (auto const &ref : refs) {
+      count += ref.value_or(false) ? 1 : 0;
+    }
+    benchmark::DoNotOptimize(count);
+  }
+}
+BENCHMARK(count_packed_bits);
+
+}  // namespace
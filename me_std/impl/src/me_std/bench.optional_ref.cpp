@@ -0,0 +1,60 @@
+#include <me_std/optional_ref.hpp>
+#include <optional>
+#include <string>
+
+#include "benchmark_support.hpp"
+
+namespace {
+using namespace me_std::bench;
+
+struct database {
+  std::string host;
+};
+
+struct config {
+  std::optional<database> db;
+};
+
+config make_config() { return config{database{std::string(64, 'h')}}; }
+
+// The chain through the std::optional conversion, which copies at each step.
+void projection_through_optional(benchmark::State &state) {
+  auto const value = make_config();
+  me_std::optional_ref<config const &> const source{value};
+  allocation_counter const allocations{state};
+  for (auto _ : state) {
+    std::optional<config> const copied = source;
+    std::optional<std::string> const host = (copied.has_value() && copied->db.has_value())
+                                                 ? std::optional<std::string>{copied->db->host}
+                                                 : std::nullopt;
+    benchmark::DoNotOptimize(&host);
+  }
+}
+BENCHMARK(projection_through_optional);
+
+void projection_by_hand(benchmark::State &state) {
+  auto const value = make_config();
+  config const *source{&value};
+  allocation_counter const allocations{state};
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(source);
+    std::string const *const host = ((source != nullptr) && source->db.has_value())
+                                        ? &source->db->host
+                                        : nullptr;
+    benchmark::DoNotOptimize(host);
+  }
+}
+BENCHMARK(projection_by_hand);
+
+void projection_and_then_transform(benchmark::State &state) {
+  auto const value = make_config();
+  me_std::optional_ref<config const &> source{value};
+  allocation_counter const allocations{state};
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(source);
+    benchmark::DoNotOptimize(source.and_then(&config::db).transform(&database::host));
+  }
+}
+BENCHMARK(projection_and_then_transform);
+
+}  // namespace
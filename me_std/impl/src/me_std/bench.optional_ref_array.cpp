@@ -0,0 +1,81 @@
+#include <me_std/optional_ref.hpp>
+#include <me_std/optional_ref_array.hpp>
+#include <vector>
+
+#include "benchmark_support.hpp"
+
+namespace {
+using namespace me_std::bench;
+
+constexpr std::size_t entry_count = 1U << 16U;
+
+// Every state.range(0)-th entry is present.
+template <typename Sequence>
+Sequence make_sequence(std::vector<int> const &values, std::size_t stride) {
+  Sequence sequence{};
+  for (std::size_t index = 0; index < values.size(); ++index) {
+    sequence.push_back((index % stride) == 0U ? me_std::optional_ref<int const &>{values[index]}
+                                              : me_std::optional_ref<int const &>{});
+  }
+  return sequence;
+}
+
+void count_vector(benchmark::State &state) {
+  std::vector<int> const values(entry_count, 1);
+  auto const refs = make_sequence<std::vector<me_std::optional_ref<int const &>>>(
+      values, static_cast<std::size_t>(state.range(0)));
+  for (auto _ : state) {
+    std::size_t present{0};
+    for (auto const ref : refs) {
+      present += ref.has_value() ? 1U : 0U;
+    }
+    benchmark::DoNotOptimize(present);
+  }
+  state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(entry_count));
+}
+BENCHMARK(count_vector)->Arg(1)->Arg(8)->Arg(64)->Arg(1024);
+
+void count_array(benchmark::State &state) {
+  std::vector<int> const values(entry_count, 1);
+  auto const refs = make_sequence<me_std::optional_ref_array<int const &>>(
+      values, static_cast<std::size_t>(state.range(0)));
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(refs.count());
+  }
+  state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(entry_count));
+}
+BENCHMARK(count_array)->Arg(1)->Arg(8)->Arg(64)->Arg(1024);
+
+void sum_present_vector(benchmark::State &state) {
+  std::vector<int> const values(entry_count, 1);
+  auto const refs = make_sequence<std::vector<me_std::optional_ref<int const &>>>(
+      values, static_cast<std::size_t>(state.range(0)));
+  for (auto _ : state) {
+    int sum{0};
+    for (auto const ref : refs) {
+      if (ref.has_value()) {
+        sum += *ref;
+      }
+    }
+    benchmark::DoNotOptimize(sum);
+  }
+  state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(entry_count));
+}
+BENCHMARK(sum_present_vector)->Arg(1)->Arg(8)->Arg(64)->Arg(1024);
+
+void sum_present_array(benchmark::State &state) {
+  std::vector<int> const values(entry_count, 1);
+  auto const refs = make_sequence<me_std::optional_ref_array<int const &>>(
+      values, static_cast<std::size_t>(state.range(0)));
+  for (auto _ : state) {
+    int sum{0};
+    for (auto const ref : refs.present()) {
+      sum += *ref;
+    }
+    benchmark::DoNotOptimize(sum);
+  }
+  state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(entry_count));
+}
+BENCHMARK(sum_present_array)->Arg(1)->Arg(8)->Arg(64)->Arg(1024);
+
+}  // namespace
@@ -0,0 +1,83 @@
+#include <cstdint>
+#include <me_std/optional_ref.hpp>
+#include <me_std/optional_ref_batch.hpp>
+#include <vector>
+
+#include "benchmark_support.hpp"
+
+namespace {
+using namespace me_std::bench;
+
+constexpr std::size_t entry_count = 1U << 16U;
+
+// Every eighth ref is empty.
+template <typename T>
+std::vector<me_std::optional_ref<T const &>> make_refs(std::vector<T> const &values) {
+  std::vector<me_std::optional_ref<T const &>> refs{};
+  for (std::size_t index = 0; index < values.size(); ++index) {
+    refs.push_back((index % 8U) == 0U ? me_std::optional_ref<T const &>{}
+                                      : me_std::optional_ref<T const &>{values[index]});
+  }
+  return refs;
+}
+
+template <typename T>
+std::vector<T> make_values() {
+  std::vector<T> values(entry_count);
+  for (std::size_t index = 0; index < values.size(); ++index) {
+    values[index] = static_cast<T>((index * 7919U) % 1000U);
+  }
+  return values;
+}
+
+// The scalar operator set applied one ref at a time.
+template <typename T>
+void less_operator(benchmark::State &state) {
+  auto const values = make_values<T>();
+  auto const refs = make_refs(values);
+  std::vector<std::uint64_t> mask(me_std::batch_mask_size(entry_count));
+  auto const threshold = static_cast<T>(500);
+  for (auto _ : state) {
+    for (std::size_t index = 0; index < refs.size(); ++index) {
+      auto const bit = std::uint64_t{refs[index] < threshold};
+      auto &word = mask[index / 64U];
+      word = ((index % 64U) == 0U) ? bit : (word | (bit << (index % 64U)));
+    }
+    benchmark::DoNotOptimize(mask.data());
+  }
+  state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(entry_count));
+}
+BENCHMARK_TEMPLATE(less_operator, int);
+BENCHMARK_TEMPLATE(less_operator, double);
+
+template <typename T>
+void less_mask(benchmark::State &state) {
+  auto const values = make_values<T>();
+  auto const refs = make_refs(values);
+  std::vector<std::uint64_t> mask(me_std::batch_mask_size(entry_count));
+  auto const threshold = static_cast<T>(500);
+  for (auto _ : state) {
+    me_std::less_mask(refs.data(), refs.size(), threshold, mask.data());
+    benchmark::DoNotOptimize(mask.data());
+  }
+  state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(entry_count));
+}
+BENCHMARK_TEMPLATE(less_mask, int);
+BENCHMARK_TEMPLATE(less_mask, double);
+
+template <typename T>
+void less_mask_elementwise(benchmark::State &state) {
+  auto const values = make_values<T>();
+  auto const lhs = make_refs(values);
+  auto const rhs = std::vector<me_std::optional_ref<T const &>>(lhs.rbegin(), lhs.rend());
+  std::vector<std::uint64_t> mask(me_std::batch_mask_size(entry_count));
+  for (auto _ : state) {
+    me_std::less_mask(lhs.data(), rhs.data(), lhs.size(), mask.data());
+    benchmark::DoNotOptimize(mask.data());
+  }
+  state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(entry_count));
+}
+BENCHMARK_TEMPLATE(less_mask_elementwise, int);
+BENCHMARK_TEMPLATE(less_mask_elementwise, double);
+
+}  // namespace
@@ -0,0 +1,138 @@
+#include <algorithm>
+#include <me_std/optional_ref.hpp>
+#include <me_std/ref_algorithm.hpp>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "benchmark_support.hpp"
+
+namespace {
+using namespace me_std::bench;
+
+template <typename T>
+T random_value(std::mt19937_64 &generator);
+
+template <>
+int random_value<int>(std::mt19937_64 &generator) {
+  return static_cast<int>(generator());
+}
+
+// Short enough to stay within the small string buffer of the referent.
+template <>
+std::string random_value<std::string>(std::mt19937_64 &generator) {
+  std::string value(12, 'a');
+  for (auto &character : value) {
+    character = static_cast<char>('a' + (generator() % 26U));
+  }
+  return value;
+}
+
+// Referents in random memory order relative to the refs, one in 16 refs empty.
+template <typename T>
+struct sort_input {
+  explicit sort_input(std::size_t count) {
+    std::mt19937_64 generator{42U};
+    values.reserve(count);
+    for (std::size_t index = 0; index < count; ++index) {
+      values.push_back(random_value<T>(generator));
+    }
+    refs.reserve(count);
+    for (std::size_t index = 0; index < count; ++index) {
+      auto const pick = generator() % count;
+      refs.push_back((index % 16U) == 0U ? me_std::optional_ref<T const &>{}
+                                         : me_std::optional_ref<T const &>{values[pick]});
+    }
+  }
+
+  std::vector<T> values{};
+  std::vector<me_std::optional_ref<T const &>> refs{};
+};
+
+template <typename T, typename Sort>
+void run_sort(benchmark::State &state, Sort sort) {
+  sort_input<T> const input{static_cast<std::size_t>(state.range(0))};
+  auto refs = input.refs;
+  for (auto _ : state) {
+    state.PauseTiming();
+    refs = input.refs;
+    state.ResumeTiming();
+    sort(refs.begin(), refs.end());
+    benchmark::ClobberMemory();
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+template <typename T>
+void std_sort(benchmark::State &state) {
+  run_sort<T>(state, [](auto first, auto last) { std::sort(first, last); });
+}
+
+template <typename T>
+void sort_refs(benchmark::State &state) {
+  run_sort<T>(state, [](auto first, auto last) { me_std::sort_refs(first, last); });
+}
+
+template <typename T>
+void std_stable_sort(benchmark::State &state) {
+  run_sort<T>(state, [](auto first, auto last) { std::stable_sort(first, last); });
+}
+
+template <typename T>
+void stable_sort_refs(benchmark::State &state) {
+  run_sort<T>(state, [](auto first, auto last) { me_std::stable_sort_refs(first, last); });
+}
+
+template <typename T, typename Search>
+void run_search(benchmark::State &state, Search search) {
+  sort_input<T> input{static_cast<std::size_t>(state.range(0))};
+  me_std::sort_refs(input.refs.begin(), input.refs.end());
+  std::mt19937_64 generator{7U};
+  std::vector<T> keys{};
+  for (std::size_t index = 0; index < 1024U; ++index) {
+    keys.push_back(random_value<T>(generator));
+  }
+  std::size_t key_index{0};
+  for (auto _ : state) {
+    auto const &key = keys[key_index++ % keys.size()];
+    benchmark::DoNotOptimize(search(input.refs.begin(), input.refs.end(), key));
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+
+template <typename T>
+void std_lower_bound(benchmark::State &state) {
+  run_search<T>(state, [](auto first, auto last, auto const &key) {
+    return std::lower_bound(first, last, key);
+  });
+}
+
+template <typename T>
+void lower_bound_refs(benchmark::State &state) {
+  run_search<T>(state, [](auto first, auto last, auto const &key) {
+    return me_std::lower_bound_refs(first, last, key);
+  });
+}
+
+// 10M entries is the size the sort is tuned for, the smaller ones show where
+// the decoration starts to pay off.
+void sort_sizes(benchmark::internal::Benchmark *benchmark) {
+  benchmark->Arg(1 << 12)->Arg(1 << 16)->Arg(1 << 20)->Arg(10'000'000);
+  benchmark->Unit(benchmark::kMillisecond);
+}
+
+BENCHMARK_TEMPLATE(std_sort, int)->Apply(sort_sizes);
+BENCHMARK_TEMPLATE(sort_refs, int)->Apply(sort_sizes);
+BENCHMARK_TEMPLATE(std_sort, std::string)->Apply(sort_sizes);
+BENCHMARK_TEMPLATE(sort_refs, std::string)->Apply(sort_sizes);
+BENCHMARK_TEMPLATE(std_stable_sort, int)->Apply(sort_sizes);
+BENCHMARK_TEMPLATE(stable_sort_refs, int)->Apply(sort_sizes);
+BENCHMARK_TEMPLATE(std_stable_sort, std::string)->Apply(sort_sizes);
+BENCHMARK_TEMPLATE(stable_sort_refs, std::string)->Apply(sort_sizes);
+
+BENCHMARK_TEMPLATE(std_lower_bound, int)->Arg(1 << 16)->Arg(1 << 20)->Arg(10'000'000);
+BENCHMARK_TEMPLATE(lower_bound_refs, int)->Arg(1 << 16)->Arg(1 << 20)->Arg(10'000'000);
+BENCHMARK_TEMPLATE(std_lower_bound, std::string)->Arg(1 << 16)->Arg(1 << 20)->Arg(10'000'000);
+BENCHMARK_TEMPLATE(lower_bound_refs, std::string)->Arg(1 << 16)->Arg(1 << 20)->Arg(10'000'000);
+
+}  // namespace
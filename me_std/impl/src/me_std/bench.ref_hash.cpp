@@ -0,0 +1,58 @@
+#include <me_std/optional_ref.hpp>
+#include <me_std/ref_hash.hpp>
+#include <string>
+#include <unordered_map>
+
+#include "benchmark_support.hpp"
+
+namespace {
+using namespace me_std::bench;
+
+using transparent_map = std::unordered_map<std::string, int, me_std::ref_hash<std::string>,
+                                           me_std::ref_equal_to<std::string>>;
+
+transparent_map make_map() {
+  transparent_map map{};
+  for (int key = 0; key < 64; ++key) {
+    map.emplace(heap_string_value::make(key), key);
+  }
+  return map;
+}
+
+// The hand-written lookup of today: materialize the key to find it.
+void find_by_copied_key(benchmark::State &state) {
+  auto const map = make_map();
+  auto const key = heap_string_value::make(7);
+  me_std::optional_ref<std::string const &> const key_ref{key};
+  allocation_counter const allocations{state};
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(map.find(std::string{*key_ref}));
+  }
+}
+BENCHMARK(find_by_copied_key);
+
+#if defined(__cpp_lib_generic_unordered_lookup)
+void find_by_optional_ref(benchmark::State &state) {
+  auto const map = make_map();
+  auto const key = heap_string_value::make(7);
+  me_std::optional_ref<std::string const &> const key_ref{key};
+  allocation_counter const allocations{state};
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(map.find(key_ref));
+  }
+}
+BENCHMARK(find_by_optional_ref);
+
+void find_by_safe_ref(benchmark::State &state) {
+  auto const map = make_map();
+  auto const key = heap_string_value::make(7);
+  me_std::safe_ref<std::string const &> const key_ref{key};
+  allocation_counter const allocations{state};
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(map.find(key_ref));
+  }
+}
+BENCHMARK(find_by_safe_ref);
+#endif
+
+}  // namespace
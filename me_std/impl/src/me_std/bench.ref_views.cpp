@@ -0,0 +1,75 @@
+#include <me_std/ref_views.hpp>
+#include <vector>
+
+#include "benchmark_support.hpp"
+
+#if defined(__cpp_lib_ranges)
+
+namespace {
+using namespace me_std::bench;
+
+// Every third ref is empty.
+struct ref_sequence {
+  explicit ref_sequence(int size) : values(static_cast<std::size_t>(size)) {
+    for (std::size_t index = 0U; index < values.size(); ++index) {
+      values[index] = static_cast<int>(index);
+      refs.push_back((index % 3U) == 2U ? me_std::optional_ref<int const &>{}
+                                        : me_std::optional_ref<int const &>{values[index]});
+    }
+  }
+
+  std::vector<int> values;
+  std::vector<me_std::optional_ref<int const &>> refs;
+};
+
+// The staging the views replace: the present values copied out first.
+void present_values_copied(benchmark::State &state) {
+  ref_sequence const sequence{static_cast<int>(state.range(0))};
+  allocation_counter const allocations{state};
+  for (auto _ : state) {
+    std::vector<int> present{};
+    for (auto ref : sequence.refs) {
+      if (ref.has_value()) {
+        present.push_back(*ref);
+      }
+    }
+    long sum{0};
+    for (int value : present) {
+      sum += value;
+    }
+    benchmark::DoNotOptimize(sum);
+  }
+}
+BENCHMARK(present_values_copied)->Arg(1024);
+
+void present_values_by_hand(benchmark::State &state) {
+  ref_sequence const sequence{static_cast<int>(state.range(0))};
+  allocation_counter const allocations{state};
+  for (auto _ : state) {
+    long sum{0};
+    for (auto ref : sequence.refs) {
+      if (ref.has_value()) {
+        sum += *ref;
+      }
+    }
+    benchmark::DoNotOptimize(sum);
+  }
+}
+BENCHMARK(present_values_by_hand)->Arg(1024);
+
+void present_values_views(benchmark::State &state) {
+  ref_sequence const sequence{static_cast<int>(state.range(0))};
+  allocation_counter const allocations{state};
+  for (auto _ : state) {
+    long sum{0};
+    for (int value : sequence.refs | me_std::views::present | me_std::views::deref) {
+      sum += value;
+    }
+    benchmark::DoNotOptimize(sum);
+  }
+}
+BENCHMARK(present_values_views)->Arg(1024);
+
+}  // namespace
+
+#endif
@@ -0,0 +1,172 @@
+#include <functional>
+#include <me_std/optional_ref.hpp>
+#include <me_std/safe_ref.hpp>
+#include <optional>
+#include <string>
+#include <utility>
+
+#include "benchmark_support.hpp"
+
+namespace {
+using namespace me_std::bench;
+
+template <typename Value>
+struct optional_ref_wrapper {
+  using type = me_std::optional_ref<Value const &>;
+  static constexpr char const *name = "optional_ref";
+  static type make(Value const &value) { return type{value}; }
+  static Value const &get(type const &wrapper) { return *wrapper; }
+  static bool less(type const &lhs, type const &rhs) { return lhs < rhs; }
+  static std::optional<Value> to_optional(type const &wrapper) { return wrapper; }
+};
+
+template <typename Value>
+struct safe_ref_wrapper {
+  using type = me_std::safe_ref<Value const &>;
+  static constexpr char const *name = "safe_ref";
+  static type make(Value const &value) { return type{value}; }
+  static Value const &get(type const &wrapper) { return *wrapper; }
+  static bool less(type const &lhs, type const &rhs) { return lhs < rhs; }
+  static std::optional<Value> to_optional(type const &wrapper) { return *wrapper; }
+};
+
+template <typename Value>
+struct raw_pointer_wrapper {
+  using type = Value const *;
+  static constexpr char const *name = "raw_pointer";
+  static type make(Value const &value) { return &value; }
+  static Value const &get(type const &wrapper) { return *wrapper; }
+  static bool less(type const &lhs, type const &rhs) { return *lhs < *rhs; }
+  static std::optional<Value> to_optional(type const &wrapper) {
+    return wrapper != nullptr ? std::optional<Value>{*wrapper} : std::nullopt;
+  }
+};
+
+template <typename Value>
+struct reference_wrapper_wrapper {
+  using type = std::reference_wrapper<Value const>;
+  static constexpr char const *name = "reference_wrapper";
+  static type make(Value const &value) { return std::cref(value); }
+  static Value const &get(type const &wrapper) { return wrapper.get(); }
+  static bool less(type const &lhs, type const &rhs) { return lhs.get() < rhs.get(); }
+  static std::optional<Value> to_optional(type const &wrapper) { return wrapper.get(); }
+};
+
+template <typename Value>
+struct std_optional_wrapper {
+  using type = std::optional<Value>;
+  static constexpr char const *name = "std_optional";
+  static type make(Value const &value) { return type{value}; }
+  static Value const &get(type const &wrapper) { return *wrapper; }
+  static bool less(type const &lhs, type const &rhs) { return lhs < rhs; }
+  static std::optional<Value> to_optional(type const &wrapper) { return wrapper; }
+};
+
+template <template <typename> class Wrapper, typename Kind>
+void construct(benchmark::State &state) {
+  using wrapper = Wrapper<typename Kind::type>;
+  auto const value = Kind::make(0);
+  allocation_counter const allocations{state};
+  for (auto _ : state) {
+    auto const constructed = wrapper::make(value);
+    benchmark::DoNotOptimize(&constructed);
+  }
+}
+
+template <template <typename> class Wrapper, typename Kind>
+void copy(benchmark::State &state) {
+  using wrapper = Wrapper<typename Kind::type>;
+  auto const value = Kind::make(0);
+  auto const source = wrapper::make(value);
+  allocation_counter const allocations{state};
+  for (auto _ : state) {
+    auto const copied = source;
+    benchmark::DoNotOptimize(&copied);
+  }
+}
+
+// Moves the wrapper to a second slot and back, so every iteration starts from
+// the same state. Reports two moves per iteration.
+template <template <typename> class Wrapper, typename Kind>
+void move(benchmark::State &state) {
+  using wrapper = Wrapper<typename Kind::type>;
+  auto const value = Kind::make(0);
+  std::optional<typename wrapper::type> first{wrapper::make(value)};
+  std::optional<typename wrapper::type> second{};
+  allocation_counter const allocations{state};
+  for (auto _ : state) {
+    second.emplace(std::move(*first));
+    first.reset();
+    benchmark::DoNotOptimize(&*second);
+    first.emplace(std::move(*second));
+    second.reset();
+    benchmark::DoNotOptimize(&*first);
+  }
+}
+
+template <template <typename> class Wrapper, typename Kind>
+void dereference(benchmark::State &state) {
+  using wrapper = Wrapper<typename Kind::type>;
+  auto const value = Kind::make(0);
+  auto const source = wrapper::make(value);
+  allocation_counter const allocations{state};
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(Kind::touch(wrapper::get(source)));
+  }
+}
+
+// Compares equal referents, which is the worst case for strings and pages.
+template <template <typename> class Wrapper, typename Kind>
+void compare(benchmark::State &state) {
+  using wrapper = Wrapper<typename Kind::type>;
+  auto const lhs_value = Kind::make(0);
+  auto const rhs_value = Kind::make(0);
+  auto const lhs = wrapper::make(lhs_value);
+  auto const rhs = wrapper::make(rhs_value);
+  allocation_counter const allocations{state};
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(wrapper::less(lhs, rhs));
+  }
+}
+
+template <template <typename> class Wrapper, typename Kind>
+void to_optional(benchmark::State &state) {
+  using wrapper = Wrapper<typename Kind::type>;
+  auto const value = Kind::make(0);
+  auto const source = wrapper::make(value);
+  allocation_counter const allocations{state};
+  for (auto _ : state) {
+    auto const converted = wrapper::to_optional(source);
+    benchmark::DoNotOptimize(&converted);
+  }
+}
+
+template <template <typename> class Wrapper, typename Kind>
+void register_wrapper() {
+  auto const prefix = std::string{Wrapper<typename Kind::type>::name} + "<" + Kind::name + ">/";
+  benchmark::RegisterBenchmark((prefix + "construct").c_str(), construct<Wrapper, Kind>);
+  benchmark::RegisterBenchmark((prefix + "copy").c_str(), copy<Wrapper, Kind>);
+  benchmark::RegisterBenchmark((prefix + "move").c_str(), move<Wrapper, Kind>);
+  benchmark::RegisterBenchmark((prefix + "dereference").c_str(), dereference<Wrapper, Kind>);
+  benchmark::RegisterBenchmark((prefix + "compare").c_str(), compare<Wrapper, Kind>);
+  benchmark::RegisterBenchmark((prefix + "to_optional").c_str(), to_optional<Wrapper, Kind>);
+}
+
+template <typename Kind>
+void register_kind() {
+  register_wrapper<optional_ref_wrapper, Kind>();
+  register_wrapper<safe_ref_wrapper, Kind>();
+  register_wrapper<raw_pointer_wrapper, Kind>();
+  register_wrapper<reference_wrapper_wrapper, Kind>();
+  register_wrapper<std_optional_wrapper, Kind>();
+}
+
+bool const registered = [] {
+  register_kind<int_value>();
+  register_kind<sso_string_value>();
+  register_kind<heap_string_value>();
+  register_kind<page_value>();
+  return true;
+}();
+
+}  // namespace
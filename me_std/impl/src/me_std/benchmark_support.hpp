@@ -0,0 +1,74 @@
+#ifndef ME_STD_BENCHMARK_SUPPORT_HPP
+#define ME_STD_BENCHMARK_SUPPORT_HPP
+
+#include <array>
+#include <cstddef>
+#include <string>
+
+#include "allocation_count.hpp"
+#include "benchmark/benchmark.h"
+
+namespace me_std::bench {
+
+// Aggregate of one memory page, the largest referent the suite measures.
+struct page {
+  std::array<unsigned char, 4096> bytes;
+
+  friend bool operator==(page const &lhs, page const &rhs) { return lhs.bytes == rhs.bytes; }
+  friend bool operator<(page const &lhs, page const &rhs) { return lhs.bytes < rhs.bytes; }
+};
+
+struct int_value {
+  using type = int;
+  static constexpr char const *name = "int";
+  static type make(int seed) { return seed; }
+  static std::size_t touch(type const &value) { return static_cast<std::size_t>(value); }
+};
+
+struct sso_string_value {
+  using type = std::string;
+  static constexpr char const *name = "string_sso";
+  static type make(int seed) { return type(8, static_cast<char>('a' + seed)); }
+  static std::size_t touch(type const &value) { return value.size(); }
+};
+
+struct heap_string_value {
+  using type = std::string;
+  static constexpr char const *name = "string_heap";
+  static type make(int seed) { return type(256, static_cast<char>('a' + seed)); }
+  static std::size_t touch(type const &value) { return value.size(); }
+};
+
+struct page_value {
+  using type = page;
+  static constexpr char const *name = "page_4k";
+  static type make(int seed) {
+    type value{};
+    value.bytes.fill(static_cast<unsigned char>(seed));
+    return value;
+  }
+  static std::size_t touch(type const &value) { return value.bytes.back(); }
+};
+
+// Reports the global operator new calls between construction and destruction
+// as the "allocs_per_iter" counter of the benchmark.
+class allocation_counter {
+ public:
+  explicit allocation_counter(benchmark::State &state)
+      : m_state{state}, m_start{me_std::test::allocation_count()} {}
+  allocation_counter(allocation_counter const &) = delete;
+  allocation_counter &operator=(allocation_counter const &) = delete;
+  ~allocation_counter() {
+    m_state.counters["allocs_per_iter"] =
+        benchmark::Counter(static_cast<double>(me_std::test::allocation_count() - m_start),
+                           benchmark::Counter::kAvgIterations);
+  }
+
+ private:
+  benchmark::State &m_state;
+  std::size_t m_start;
+};
+
+}  // namespace me_std::bench
+
+#endif  // ME_STD_BENCHMARK_SUPPORT_HPP
@@ -0,0 +1,38 @@
+// Instantiates every comparison of optional_ref and safe_ref with each other
+// operand kind for a few referent types, so the build time of the comparison
+// overload set can be watched.
+#include <optional>
+#include <string>
+#include <string_view>
+
+#include <me_std/optional_ref.hpp>
+#include <me_std/safe_ref.hpp>
+
+namespace {
+
+template <typename Lhs, typename Rhs>
+int compare_all(Lhs const &lhs, Rhs const &rhs) {
+  return (lhs == rhs) + (lhs != rhs) + (lhs < rhs) + (lhs <= rhs) + (lhs > rhs) + (lhs >= rhs) +
+         (rhs == lhs) + (rhs != lhs) + (rhs < lhs) + (rhs <= lhs) + (rhs > lhs) + (rhs >= lhs);
+}
+
+template <typename T, typename Other>
+int compare_wrappers(T const &value, Other const &other) {
+  me_std::optional_ref<T const &> const optional_ref{value};
+  me_std::safe_ref<T const &> const safe_ref{value};
+  std::optional<T> const optional{value};
+  std::optional<Other> const other_optional{other};
+  return compare_all(optional_ref, optional_ref) + compare_all(optional_ref, value) +
+         compare_all(optional_ref, other) + compare_all(optional_ref, optional) +
+         compare_all(optional_ref, other_optional) + compare_all(safe_ref, safe_ref) +
+         compare_all(safe_ref, value) + compare_all(safe_ref, other) +
+         compare_all(safe_ref, optional) + compare_all(safe_ref, other_optional);
+}
+
+}  // namespace
+
+int compile_bench_comparisons() {
+  return compare_wrappers(1, 2L) + compare_wrappers(1.0, 2.0F) +
+         compare_wrappers(std::string{"a"}, std::string_view{"b"}) +
+         compare_wrappers(std::string_view{"a"}, std::string{"b"});
+}
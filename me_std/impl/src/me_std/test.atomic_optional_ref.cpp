@@ -0,0 +1,146 @@
+#include <atomic>
+#include <me_std/atomic_optional_ref.hpp>
+#include <me_std/optional_ref.hpp>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace {
+
+static_assert(me_std::atomic_optional_ref<std::string const &>::is_always_lock_free,
+              "atomic_optional_ref must be lock-free");
+static_assert(sizeof(me_std::atomic_optional_ref<int const &>) == sizeof(int const *),
+              "atomic_optional_ref must be a single atomic pointer");
+
+TEST(AtomicOptionalRefTest, LoadAndStore) {
+  std::string const first{"first"};
+  std::string const second{"second"};
+  me_std::atomic_optional_ref<std::string const &> test_ref{};
+  EXPECT_TRUE(test_ref.is_lock_free());
+  EXPECT_FALSE(test_ref.load().has_value());
+
+  test_ref.store(first);
+  EXPECT_EQ(&*test_ref.load(), &first);
+
+  EXPECT_EQ(&*test_ref.exchange(second), &first);
+  EXPECT_EQ(&*test_ref.load(std::memory_order_acquire), &second);
+
+  test_ref.store({});
+  EXPECT_FALSE(test_ref.load().has_value());
+}
+
+TEST(AtomicOptionalRefTest, CompareExchange) {
+  int const first{1};
+  int const second{2};
+  me_std::atomic_optional_ref<int const &> test_ref{first};
+
+  me_std::optional_ref<int const &> expected{second};
+  EXPECT_FALSE(test_ref.compare_exchange_strong(expected, second));
+  EXPECT_EQ(&*expected, &first);
+
+  EXPECT_TRUE(test_ref.compare_exchange_strong(expected, second));
+  EXPECT_EQ(&*test_ref.load(), &second);
+
+  // Equal values at different addresses are different referents.
+  int const copy{2};
+  expected = copy;
+  EXPECT_FALSE(test_ref.compare_exchange_strong(expected, {}));
+  EXPECT_EQ(&*expected, &second);
+
+  while (!test_ref.compare_exchange_weak(expected, {})) {
+  }
+  EXPECT_FALSE(test_ref.load().has_value());
+}
+
+TEST(AtomicOptionalRefTest, ProtectedReferentIsNotReclaimed) {
+  int reclaimed{0};
+  auto const count_reclaim = [&reclaimed](std::string const *value) {
+    ++reclaimed;
+    delete value;
+  };
+  me_std::atomic_optional_ref<std::string const &> test_ref{*new std::string{"first"}};
+
+  {
+    auto const guard = test_ref.protect();
+    ASSERT_TRUE(guard.has_value());
+
+    auto const previous = test_ref.exchange(*new std::string{"second"});
+    me_std::hazard_retire(previous.operator->(), count_reclaim);
+    me_std::hazard_reclaim();
+    EXPECT_EQ(reclaimed, 0);
+    EXPECT_EQ(*guard, "first");
+    EXPECT_EQ(guard->size(), 5U);
+  }
+
+  me_std::hazard_reclaim();
+  EXPECT_EQ(reclaimed, 1);
+
+  {
+    auto const guard = test_ref.protect();
+    EXPECT_EQ(*guard.get(), "second");
+    me_std::hazard_retire(test_ref.exchange({}).operator->(), count_reclaim);
+    me_std::hazard_reclaim();
+    EXPECT_EQ(reclaimed, 1);
+  }
+
+  me_std::hazard_reclaim();
+  EXPECT_EQ(reclaimed, 2);
+}
+
+TEST(AtomicOptionalRefTest, EmptyProtect) {
+  me_std::atomic_optional_ref<int const &> const test_ref{};
+  auto const guard = test_ref.protect();
+  EXPECT_FALSE(guard.has_value());
+  EXPECT_FALSE(guard.get().has_value());
+}
+
+// Readers check that the referent they protect is still alive while a writer
+// keeps replacing and retiring it.
+TEST(AtomicOptionalRefTest, ConcurrentReadersAndWriter) {
+  struct config {
+    std::atomic<bool> alive{true};
+    int version;
+  };
+  std::atomic<int> reclaimed{0};
+  auto const reclaim = [&reclaimed](config const *value) {
+    const_cast<config *>(value)->alive.store(false);
+    reclaimed.fetch_add(1);
+    delete value;
+  };
+
+  me_std::atomic_optional_ref<config const &> current{*new config{{true}, 0}};
+  std::atomic<bool> done{false};
+  std::atomic<int> failures{0};
+  std::vector<std::thread> readers{};
+  for (int reader = 0; reader < 4; ++reader) {
+    readers.emplace_back([&] {
+      int last_version{0};
+      while (!done.load()) {
+        auto const guard = current.protect();
+        if (!guard->alive.load() || (guard->version < last_version)) {
+          failures.fetch_add(1);
+        }
+        last_version = guard->version;
+      }
+    });
+  }
+
+  int constexpr updates{2000};
+  for (int version = 1; version <= updates; ++version) {
+    auto const previous = current.exchange(*new config{{true}, version});
+    me_std::hazard_retire(previous.operator->(), reclaim);
+  }
+  done.store(true);
+  for (auto &reader : readers) {
+    reader.join();
+  }
+  me_std::hazard_retire(current.exchange({}).operator->(), reclaim);
+  me_std::hazard_reclaim();
+
+  EXPECT_EQ(failures.load(), 0);
+  EXPECT_EQ(reclaimed.load(), updates + 1);
+}
+
+}  // namespace
@@ -0,0 +1,80 @@
+// Built into its own test executable with ME_STD_CHECKED_REFS defined, the
+// checked optional_ref must not meet an unchecked one within a program.
+#if !defined(ME_STD_CHECKED_REFS)
+#error "test.checked_refs.cpp requires ME_STD_CHECKED_REFS"
+#endif
+
+#include <array>
+#include <me_std/optional_ref.hpp>
+#include <me_std/ref_lifetime.hpp>
+#include <memory>
+#include <optional>
+#include <string>
+
+#include "gtest/gtest.h"
+
+namespace {
+
+struct tracked_string {
+  std::string value;
+  me_std::ref_lifetime lifetime{value};
+};
+
+static_assert(sizeof(me_std::optional_ref<int &>) > sizeof(int *));
+static_assert(std::is_trivially_copyable<me_std::optional_ref<int const &>>::value);
+
+// Constant evaluation skips the registry.
+constexpr std::array<int, 2> lookup_values{42, 43};
+constexpr me_std::optional_ref<int const &> lookup_ref{lookup_values[1]};
+static_assert(*lookup_ref == 43);
+
+TEST(CheckedRefsTest, LiveReferent) {
+  tracked_string const referent{"Hello World"};
+  me_std::optional_ref<std::string const &> const test_ref{referent.value};
+
+  EXPECT_EQ(*test_ref, "Hello World");
+  EXPECT_EQ(test_ref->size(), 11U);
+  EXPECT_EQ(test_ref.value(), "Hello World");
+  EXPECT_EQ(test_ref, std::string{"Hello World"});
+}
+
+TEST(CheckedRefsTest, UntrackedReferentIsNotChecked) {
+  std::optional<me_std::optional_ref<std::string const &>> test_ref{};
+  {
+    std::string const referent{"untracked"};
+    test_ref = me_std::optional_ref<std::string const &>{referent};
+    EXPECT_EQ(**test_ref, "untracked");
+  }
+  EXPECT_TRUE(test_ref->has_value());
+}
+
+TEST(CheckedRefsDeathTest, DestroyedReferent) {
+  std::unique_ptr<tracked_string> referent{new tracked_string{"Hello World"}};
+  me_std::optional_ref<std::string const &> const test_ref{referent->value};
+  auto const copy = test_ref;
+  referent.reset();
+
+  EXPECT_DEATH(static_cast<void>(*test_ref), "dangling optional_ref");
+  EXPECT_DEATH(static_cast<void>(copy->size()), "dangling optional_ref");
+  EXPECT_DEATH(static_cast<void>(copy.value()), "dangling optional_ref");
+  EXPECT_DEATH(static_cast<void>(copy == std::string{}), "dangling optional_ref");
+  EXPECT_TRUE(copy.has_value());
+}
+
+TEST(CheckedRefsDeathTest, ReusedAddress) {
+  std::optional<int> storage{};
+  storage.emplace(1);
+  auto lifetime = std::make_unique<me_std::ref_lifetime>(*storage);
+  me_std::optional_ref<int const &> const old_ref{storage};
+  EXPECT_EQ(*old_ref, 1);
+
+  lifetime.reset();
+  storage.emplace(2);
+  me_std::ref_lifetime const new_lifetime{*storage};
+  me_std::optional_ref<int const &> const new_ref{storage};
+
+  EXPECT_EQ(*new_ref, 2);
+  EXPECT_DEATH(static_cast<void>(*old_ref), "dangling optional_ref");
+}
+
+}  // namespace
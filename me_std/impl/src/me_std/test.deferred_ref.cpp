@@ -0,0 +1,224 @@
+#include <algorithm>
+#include <functional>
+#include <me_std/deferred_ref.hpp>
+#include <me_std/ref_algorithm.hpp>
+#include <me_std/ref_hash.hpp>
+#include <optional>
+#include <string>
+#include <thread>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+#include "allocation_count.hpp"
+#include "gtest/gtest.h"
+
+namespace {
+
+template <typename T>
+class DeferredRefTest : public ::testing::Test {};
+
+using Threadings =
+    ::testing::Types<std::integral_constant<me_std::ref_threading,
+                                            me_std::ref_threading::single_threaded>,
+                     std::integral_constant<me_std::ref_threading,
+                                            me_std::ref_threading::thread_safe>>;
+TYPED_TEST_SUITE(DeferredRefTest, Threadings);
+
+template <typename Threading>
+using string_source = me_std::ref_source<std::string, Threading::value>;
+
+template <typename Threading>
+using string_ref = me_std::deferred_ref<std::string const &, Threading::value>;
+
+TYPED_TEST(DeferredRefTest, CopiesDoNotAllocateWhileSourceLives) {
+  string_source<TypeParam> const source{std::string(64, 'a')};
+
+  std::size_t allocations{0};
+  {
+    // The first borrower allocates the storage of a later snapshot.
+    string_ref<TypeParam> const ref{source};
+    auto const allocations_before = me_std::test::allocation_count();
+    std::vector<string_ref<TypeParam>> copies(3, ref);
+    string_ref<TypeParam> assigned{source};
+    assigned = copies[1];
+    // Only the vector of copies allocated.
+    allocations = me_std::test::allocation_count() - allocations_before;
+
+    EXPECT_EQ(source.borrower_count(), 5U);
+    EXPECT_EQ(&*ref, &*source);
+    EXPECT_EQ(&*copies[2], &*source);
+    EXPECT_TRUE(assigned.is_borrowed());
+    copies.clear();
+    EXPECT_EQ(source.borrower_count(), 2U);
+  }
+  EXPECT_EQ(allocations, 1U);
+  EXPECT_EQ(source.borrower_count(), 0U);
+}
+
+TYPED_TEST(DeferredRefTest, DestroyedSourceHandsOutOneSnapshot) {
+  std::string const value(64, 'a');
+  std::optional<string_source<TypeParam>> source{value};
+  string_ref<TypeParam> const first{*source};
+  string_ref<TypeParam> const second{first};
+
+  // The snapshot was allocated with the first borrower, and the string is
+  // moved into it.
+  auto const allocations_before = me_std::test::allocation_count();
+  source.reset();
+  string_ref<TypeParam> const third{second};
+  auto const allocations = me_std::test::allocation_count() - allocations_before;
+  EXPECT_EQ(allocations, 0U);
+
+  EXPECT_FALSE(first.is_borrowed());
+  EXPECT_EQ(*first, value);
+  EXPECT_EQ(&*first, &*second);
+  EXPECT_EQ(&*third, &*first);
+}
+
+TYPED_TEST(DeferredRefTest, ModifyDetachesCurrentBorrowers) {
+  string_source<TypeParam> source{std::string{"before"}};
+  string_ref<TypeParam> const before{source};
+
+  source.modify() = "after";
+  string_ref<TypeParam> const after{source};
+
+  EXPECT_EQ(*before, "before");
+  EXPECT_EQ(*after, "after");
+  EXPECT_FALSE(before.is_borrowed());
+  EXPECT_TRUE(after.is_borrowed());
+  EXPECT_EQ(source.borrower_count(), 1U);
+
+  // The snapshot was allocated when after attached and a short string takes
+  // no allocation of its own. Without borrowers nothing is snapshot.
+  auto const allocations_before = me_std::test::allocation_count();
+  source.modify() = "again";
+  static_cast<void>(source.modify());
+  auto const allocations = me_std::test::allocation_count() - allocations_before;
+  EXPECT_EQ(allocations, 0U);
+  EXPECT_EQ(*after, "after");
+  EXPECT_EQ(source.borrower_count(), 0U);
+}
+
+// Copies, but its move may throw, so the destructor of a source copies it.
+struct throwing_move {
+  throwing_move() = default;
+  throwing_move(throwing_move const &) noexcept = default;
+  throwing_move(throwing_move &&) noexcept(false) {}
+  int value{7};
+};
+
+TYPED_TEST(DeferredRefTest, DestroyedSourceCopiesValueWithThrowingMove) {
+  std::optional<me_std::ref_source<throwing_move, TypeParam::value>> source{std::in_place,
+                                                                             throwing_move{}};
+  me_std::deferred_ref<throwing_move const &, TypeParam::value> const ref{*source};
+
+  source.reset();
+
+  EXPECT_FALSE(ref.is_borrowed());
+  EXPECT_EQ(ref->value, 7);
+}
+
+TYPED_TEST(DeferredRefTest, MovedSourceDetachesBorrowers) {
+  string_source<TypeParam> source{std::string(64, 'a')};
+  string_ref<TypeParam> const ref{source};
+
+  string_source<TypeParam> const moved{std::move(source)};
+
+  EXPECT_FALSE(ref.is_borrowed());
+  EXPECT_EQ(*ref, *moved);
+  EXPECT_EQ(moved.borrower_count(), 0U);
+}
+
+TYPED_TEST(DeferredRefTest, Compare) {
+  string_source<TypeParam> const first{std::string{"a"}};
+  string_source<TypeParam> const second{std::string{"b"}};
+  string_ref<TypeParam> const first_ref{first};
+  string_ref<TypeParam> const second_ref{second};
+
+  EXPECT_TRUE(first_ref == string_ref<TypeParam>{first});
+  EXPECT_TRUE(first_ref != second_ref);
+  EXPECT_TRUE(first_ref < second_ref);
+  EXPECT_TRUE(first_ref <= second_ref);
+  EXPECT_TRUE(second_ref > first_ref);
+  EXPECT_TRUE(second_ref >= first_ref);
+  EXPECT_FALSE(first_ref > first_ref);
+  EXPECT_EQ(first_ref->size(), 1U);
+}
+
+TYPED_TEST(DeferredRefTest, CompareWithValuesAndOptionals) {
+  string_source<TypeParam> const source{std::string{"b"}};
+  string_ref<TypeParam> const test_ref{source};
+  std::string const smaller{"a"};
+  std::optional<std::string> const larger{"c"};
+  std::optional<std::string> const empty{};
+
+  EXPECT_TRUE(test_ref == std::string{"b"});
+  EXPECT_TRUE("b" == test_ref);
+  EXPECT_TRUE(test_ref != smaller);
+  EXPECT_TRUE(smaller < test_ref);
+  EXPECT_TRUE(test_ref <= "b");
+  EXPECT_TRUE(test_ref > smaller);
+  EXPECT_TRUE("c" >= test_ref);
+
+  EXPECT_TRUE(test_ref < larger);
+  EXPECT_TRUE(larger > test_ref);
+  EXPECT_TRUE(test_ref != larger);
+  EXPECT_TRUE(test_ref > empty);
+  EXPECT_TRUE(empty <= test_ref);
+  EXPECT_FALSE(test_ref == empty);
+  EXPECT_TRUE(std::optional<std::string>{"b"} == test_ref);
+}
+
+TYPED_TEST(DeferredRefTest, HashesAndSortsAsItsReferent) {
+  std::vector<string_source<TypeParam>> sources{};
+  for (auto const *value : {"d", "b", "e", "a", "c"}) {
+    sources.emplace_back(std::string{value});
+  }
+  std::vector<string_ref<TypeParam>> refs(sources.begin(), sources.end());
+
+  EXPECT_EQ(std::hash<string_ref<TypeParam>>{}(refs[0]), std::hash<std::string>{}("d"));
+  EXPECT_EQ(me_std::ref_hash<std::string>{}(refs[0]), std::hash<std::string>{}("d"));
+  EXPECT_TRUE(me_std::ref_equal_to<std::string>{}(refs[3], std::string{"a"}));
+  EXPECT_FALSE(me_std::ref_equal_to<std::string>{}(refs[3], refs[0]));
+#if defined(__cpp_lib_generic_unordered_lookup)
+  std::unordered_set<std::string, me_std::ref_hash<std::string>, me_std::ref_equal_to<std::string>>
+      const values{"a", "c"};
+  EXPECT_NE(values.find(refs[3]), values.end());
+  EXPECT_EQ(values.find(refs[0]), values.end());
+#endif
+
+  me_std::sort_refs(refs.begin(), refs.end());
+  EXPECT_TRUE(std::is_sorted(refs.begin(), refs.end()));
+  EXPECT_TRUE(std::all_of(refs.begin(), refs.end(), [](auto const &ref) {
+    return ref.is_borrowed();
+  }));
+  EXPECT_EQ(me_std::lower_bound_refs(refs.begin(), refs.end(), std::string{"c"}), refs.begin() + 2);
+}
+
+TEST(DeferredRefThreadTest, BorrowersOnOtherThreads) {
+  using source_type = me_std::ref_source<std::string, me_std::ref_threading::thread_safe>;
+  using ref_type = me_std::deferred_ref<std::string const &, me_std::ref_threading::thread_safe>;
+
+  for (int round = 0; round < 20; ++round) {
+    std::optional<source_type> source{std::string(64, 'a')};
+    ref_type const ref{*source};
+    std::vector<std::thread> threads{};
+    for (int thread = 0; thread < 4; ++thread) {
+      threads.emplace_back([&ref] {
+        for (int copy = 0; copy < 200; ++copy) {
+          ref_type const copied{ref};
+          EXPECT_EQ(copied->size(), 64U);
+        }
+      });
+    }
+    source.reset();
+    for (auto &thread : threads) {
+      thread.join();
+    }
+    EXPECT_FALSE(ref.is_borrowed());
+    EXPECT_EQ(*ref, std::string(64, 'a'));
+  }
+}
+
+}  // namespace
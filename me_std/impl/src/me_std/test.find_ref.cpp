@@ -0,0 +1,169 @@
+#include <array>
+#include <map>
+#include <me_std/find_ref.hpp>
+#include <memory>
+#include <set>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+
+#include "allocation_count.hpp"
+#include "gtest/gtest.h"
+
+namespace {
+
+TEST(FindRefTest, Map) {
+  std::map<int, std::string> map{{1, "one"}, {2, "two"}};
+  auto const found = me_std::find_ref(map, 2);
+  static_assert(std::is_same<decltype(found), me_std::optional_ref<std::string &> const>::value);
+
+  ASSERT_TRUE(found.has_value());
+  EXPECT_EQ(&*found, &map.at(2));
+  EXPECT_FALSE(me_std::find_ref(map, 3).has_value());
+
+  me_std::find_ref(map, 1).value() = "uno";
+  EXPECT_EQ(map.at(1), "uno");
+}
+
+TEST(FindRefTest, ConstMap) {
+  std::map<int, std::string> const map{{1, "one"}, {2, "two"}};
+  auto const found = me_std::find_ref(map, 1);
+  static_assert(
+      std::is_same<decltype(found), me_std::optional_ref<std::string const &> const>::value);
+
+  EXPECT_EQ(found, std::string{"one"});
+  EXPECT_FALSE(me_std::find_ref(map, 3).has_value());
+}
+
+TEST(FindRefTest, UnorderedMap) {
+  std::unordered_map<std::string, int> map{{"one", 1}, {"two", 2}};
+  EXPECT_EQ(me_std::find_ref(map, std::string{"two"}), 2);
+  EXPECT_FALSE(me_std::find_ref(map, std::string{"three"}).has_value());
+}
+
+TEST(FindRefTest, Set) {
+  std::set<std::string> set{"one", "two"};
+  auto const found = me_std::find_ref(set, std::string{"one"});
+  static_assert(
+      std::is_same<decltype(found), me_std::optional_ref<std::string const &> const>::value);
+
+  EXPECT_EQ(&*found, &*set.find("one"));
+  EXPECT_FALSE(me_std::find_ref(set, std::string{"three"}).has_value());
+}
+
+TEST(FindRefTest, HeterogeneousKeyDoesNotAllocate) {
+  std::map<std::string, int, std::less<>> const map{{std::string(64, 'a'), 1},
+                                                     {std::string(64, 'b'), 2}};
+  std::string const key(64, 'b');
+  std::string_view const key_view{key};
+
+  auto const allocations_before = me_std::test::allocation_count();
+  auto const found = me_std::find_ref(map, key_view);
+  auto const missing = me_std::find_ref(map, key_view.substr(1));
+  EXPECT_EQ(allocations_before, me_std::test::allocation_count());
+
+  EXPECT_EQ(found, 2);
+  EXPECT_FALSE(missing.has_value());
+}
+
+#if defined(__cpp_lib_generic_unordered_lookup)
+struct string_hash {
+  using is_transparent = void;
+  std::size_t operator()(std::string_view value) const noexcept {
+    return std::hash<std::string_view>{}(value);
+  }
+};
+
+TEST(FindRefTest, HeterogeneousUnorderedKeyDoesNotAllocate) {
+  std::unordered_map<std::string, int, string_hash, std::equal_to<>> const map{
+      {std::string(64, 'a'), 1}, {std::string(64, 'b'), 2}};
+  std::string const key(64, 'a');
+
+  auto const allocations_before = me_std::test::allocation_count();
+  auto const found = me_std::find_ref(map, std::string_view{key});
+  EXPECT_EQ(allocations_before, me_std::test::allocation_count());
+
+  EXPECT_EQ(found, 1);
+}
+#endif
+
+TEST(FindRefTest, SortedVector) {
+  std::vector<int> values{1, 3, 5, 7};
+  auto const found = me_std::find_ref(me_std::sorted, values, 5);
+  static_assert(std::is_same<decltype(found), me_std::optional_ref<int &> const>::value);
+
+  EXPECT_EQ(&*found, &values[2]);
+  EXPECT_FALSE(me_std::find_ref(me_std::sorted, values, 4).has_value());
+  EXPECT_FALSE(me_std::find_ref(me_std::sorted, values, 8).has_value());
+  std::vector<int> const empty{};
+  EXPECT_FALSE(me_std::find_ref(me_std::sorted, empty, 1).has_value());
+}
+
+TEST(FindRefTest, SortedVectorWithCompare) {
+  std::vector<std::string> const values{"two", "three", "one", "four"};
+  auto const found = me_std::find_ref(me_std::sorted, values, std::string_view{"one"},
+                                      std::greater<>{});
+  static_assert(
+      std::is_same<decltype(found), me_std::optional_ref<std::string const &> const>::value);
+
+  EXPECT_EQ(&*found, &values[2]);
+  EXPECT_FALSE(me_std::find_ref(me_std::sorted, values, std::string_view{"five"},
+                                std::greater<>{})
+                   .has_value());
+}
+
+TEST(FindRefTest, Pointer) {
+  int value{42};
+  int *pointer{&value};
+  int const *const_pointer{nullptr};
+
+  EXPECT_EQ(&*me_std::find_ref(pointer), &value);
+  EXPECT_FALSE(me_std::find_ref(const_pointer).has_value());
+  static_assert(std::is_same<decltype(me_std::find_ref(const_pointer)),
+                             me_std::optional_ref<int const &>>::value);
+}
+
+TEST(FindRefTest, SmartPointer) {
+  auto const unique = std::make_unique<std::string>("unique");
+  auto const shared = std::make_shared<std::string const>("shared");
+  std::unique_ptr<int> const empty{};
+
+  EXPECT_EQ(me_std::find_ref(unique), std::string{"unique"});
+  EXPECT_EQ(me_std::find_ref(shared), std::string{"shared"});
+  EXPECT_FALSE(me_std::find_ref(empty).has_value());
+  static_assert(std::is_same<decltype(me_std::find_ref(shared)),
+                             me_std::optional_ref<std::string const &>>::value);
+}
+
+TEST(FindRefTest, AtRef) {
+  std::vector<int> values{1, 2, 3};
+  std::array<int, 2> const array{4, 5};
+
+  EXPECT_EQ(&*me_std::at_ref(values, 2), &values[2]);
+  EXPECT_FALSE(me_std::at_ref(values, 3).has_value());
+  EXPECT_EQ(me_std::at_ref(array, 1), 5);
+  EXPECT_FALSE(me_std::at_ref(array, 2).has_value());
+  static_assert(std::is_same<decltype(me_std::at_ref(array, 0)),
+                             me_std::optional_ref<int const &>>::value);
+}
+
+TEST(FindRefTest, AtRefByKey) {
+  std::map<std::size_t, std::string> map{{0U, "zero"}, {2U, "two"}};
+  std::unordered_map<std::string, int> const unordered_map{{"one", 1}, {"two", 2}};
+
+  EXPECT_EQ(&*me_std::at_ref(map, std::size_t{2}), &map.at(2));
+  EXPECT_FALSE(me_std::at_ref(map, std::size_t{1}).has_value());
+  me_std::at_ref(map, std::size_t{0}).value() = "null";
+  EXPECT_EQ(map.at(0), "null");
+  static_assert(std::is_same<decltype(me_std::at_ref(map, std::size_t{0})),
+                             me_std::optional_ref<std::string &>>::value);
+
+  EXPECT_EQ(me_std::at_ref(unordered_map, std::string{"two"}), 2);
+  EXPECT_FALSE(me_std::at_ref(unordered_map, std::string{"three"}).has_value());
+  static_assert(std::is_same<decltype(me_std::at_ref(unordered_map, std::string{"one"})),
+                             me_std::optional_ref<int const &>>::value);
+}
+
+}  // namespace
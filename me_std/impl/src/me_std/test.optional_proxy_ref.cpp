@@ -0,0 +1,161 @@
+#include <array>
+#include <bitset>
+#include <cstdint>
+#include <me_std/optional_proxy_ref.hpp>
+#include <optional>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace {
+
+// Two 4 bit values per byte, the compressed storage of the custom accessor below.
+class nibble_array {
+ public:
+  class reference {
+   public:
+    reference(std::uint8_t &byte, bool high) noexcept : m_byte{&byte}, m_high{high} {}
+
+    operator std::uint8_t() const noexcept {
+      return static_cast<std::uint8_t>(m_high ? (*m_byte >> 4U) : (*m_byte & 0x0FU));
+    }
+
+    reference &operator=(std::uint8_t value) noexcept {
+      *m_byte = static_cast<std::uint8_t>(
+          m_high ? ((*m_byte & 0x0FU) | (value << 4U)) : ((*m_byte & 0xF0U) | (value & 0x0FU)));
+      return *this;
+    }
+
+   private:
+    std::uint8_t *m_byte;
+    bool m_high;
+  };
+
+  explicit nibble_array(std::size_t size) : m_bytes((size + 1U) / 2U) {}
+
+  reference at(std::size_t index) noexcept {
+    return reference{m_bytes[index / 2U], (index % 2U) == 1U};
+  }
+
+  std::uint8_t *data() noexcept { return m_bytes.data(); }
+
+ private:
+  std::vector<std::uint8_t> m_bytes;
+};
+
+// Locates a nibble by the address of its byte shifted left, and its half in
+// the freed bit.
+struct nibble_accessor {
+  using reference = nibble_array::reference;
+  using value_type = std::uint8_t;
+  using locator_type = std::uintptr_t;
+
+  static constexpr locator_type empty() noexcept { return 0U; }
+  static constexpr bool is_empty(locator_type locator) noexcept { return locator == 0U; }
+  static locator_type locate(nibble_array &array, std::size_t index) noexcept {
+    return (reinterpret_cast<std::uintptr_t>(array.data() + (index / 2U)) << 1U) | (index % 2U);
+  }
+  static reference access(locator_type locator) noexcept {
+    return reference{*reinterpret_cast<std::uint8_t *>(locator >> 1U),
+                     (locator & 1U) == 1U};
+  }
+};
+
+using nibble_ref = me_std::optional_proxy_ref<nibble_accessor>;
+
+static_assert(sizeof(nibble_ref) == sizeof(std::uintptr_t));
+static_assert(sizeof(me_std::optional_proxy_ref<me_std::reference_accessor<std::string const &>>) ==
+              sizeof(std::string const *));
+
+constexpr std::array<int, 2> constexpr_values{1, 2};
+constexpr me_std::optional_proxy_ref<me_std::reference_accessor<int const &>> constexpr_ref{
+    constexpr_values[1]};
+static_assert(constexpr_ref.has_value() && (*constexpr_ref == 2));
+static_assert(constexpr_ref == 2 && 1 < constexpr_ref);
+
+TEST(OptionalProxyRefTest, VectorBool) {
+  std::vector<bool> bits(10, false);
+  me_std::optional_element_ref<std::vector<bool>> const bit{bits, 3};
+  me_std::optional_element_ref<std::vector<bool>> const empty{};
+
+  ASSERT_TRUE(bit.has_value());
+  EXPECT_FALSE(empty.has_value());
+  EXPECT_TRUE(bit == false);
+
+  *bit = true;
+  EXPECT_TRUE(bits[3]);
+  EXPECT_TRUE(bit == true);
+  EXPECT_EQ(std::optional<bool>{bit}, true);
+  EXPECT_EQ(empty.value_or(true), true);
+  EXPECT_THROW(static_cast<void>(empty.value()), std::bad_optional_access);
+}
+
+TEST(OptionalProxyRefTest, Bitset) {
+  std::bitset<8> bits{0b0000'0100U};
+  me_std::optional_element_ref<std::bitset<8>> const bit{bits, 2};
+  static_assert(std::is_same<decltype(bit)::value_type, bool>::value);
+
+  EXPECT_TRUE(bit == true);
+  *bit = false;
+  EXPECT_TRUE(bits.none());
+}
+
+TEST(OptionalProxyRefTest, Column) {
+  struct particles {
+    std::vector<float> x;
+    std::vector<float> y;
+  } columns{{1.0F, 2.0F}, {3.0F, 4.0F}};
+  me_std::optional_element_ref<std::vector<float>> const y{columns.y, 1};
+  static_assert(std::is_same<decltype(y)::reference_type, float &>::value);
+
+  EXPECT_EQ(&*y, &columns.y[1]);
+  *y = 5.0F;
+  EXPECT_EQ(columns.y[1], 5.0F);
+}
+
+TEST(OptionalProxyRefTest, CustomAccessor) {
+  nibble_array nibbles{4};
+  nibbles.at(1) = 9;
+  nibbles.at(2) = 3;
+  nibble_ref const second{nibbles, 1};
+  nibble_ref const third{nibbles, 2};
+
+  EXPECT_TRUE(second == 9);
+  EXPECT_TRUE(third < second);
+  *third = 12;
+  EXPECT_EQ(static_cast<int>(nibbles.at(2)), 12);
+  EXPECT_EQ(static_cast<int>(nibbles.at(3)), 0);
+  EXPECT_TRUE(second < third);
+}
+
+TEST(OptionalProxyRefTest, Compare) {
+  std::vector<bool> bits{false, true, true};
+  me_std::optional_element_ref<std::vector<bool>> const clear{bits, 0};
+  me_std::optional_element_ref<std::vector<bool>> const set{bits, 1};
+  me_std::optional_element_ref<std::vector<bool>> const other_set{bits, 2};
+  me_std::optional_element_ref<std::vector<bool>> const empty{};
+
+  EXPECT_TRUE(empty == me_std::optional_element_ref<std::vector<bool>>{});
+  EXPECT_TRUE(set == other_set);
+  EXPECT_TRUE(empty != clear);
+  EXPECT_TRUE(empty < clear);
+  EXPECT_TRUE(clear < set);
+  EXPECT_TRUE(set >= other_set);
+  EXPECT_TRUE(set > clear);
+  EXPECT_TRUE(clear <= set);
+
+  EXPECT_TRUE(set == true);
+  EXPECT_TRUE(false != set);
+  EXPECT_TRUE(empty < false);
+  EXPECT_TRUE(true >= set);
+  EXPECT_TRUE(empty != true);
+
+  EXPECT_TRUE(set == std::optional<bool>{true});
+  EXPECT_TRUE(empty == std::optional<bool>{});
+  EXPECT_TRUE(std::optional<bool>{} < clear);
+  EXPECT_TRUE(set > std::optional<bool>{false});
+}
+
+}  // namespace
@@ -1,8 +1,13 @@
 #include <array>
 #include <me_std/optional_ref.hpp>
+#include <memory>
+#include <mutex>
 #include <optional>
 #include <string>
+#include <string_view>
+#include <typeinfo>
 
+#include "allocation_count.hpp"
 #include "gtest/gtest.h"
 
 namespace {
@@ -25,6 +30,56 @@ std::string get_value<std::string>(ValueType type) {
   return value[static_cast<std::underlying_type_t<ValueType>>(type)];
 }
 
+template <typename T>
+constexpr bool is_pointer_like =
+    std::is_trivially_copyable_v<me_std::optional_ref<T>> &&
+    std::is_trivially_destructible_v<me_std::optional_ref<T>> &&
+    (sizeof(me_std::optional_ref<T>) == sizeof(std::remove_reference_t<T> *)) &&
+    (alignof(me_std::optional_ref<T>) == alignof(std::remove_reference_t<T> *));
+
+static_assert(is_pointer_like<int const &>);
+static_assert(is_pointer_like<std::string const &>);
+static_assert(is_pointer_like<int &>);
+static_assert(is_pointer_like<std::string &>);
+
+template <typename T>
+constexpr bool is_noexcept_accessible =
+    std::is_nothrow_default_constructible_v<me_std::optional_ref<T>> &&
+    std::is_nothrow_constructible_v<me_std::optional_ref<T>, T> &&
+    std::is_nothrow_copy_constructible_v<me_std::optional_ref<T>> &&
+    std::is_nothrow_copy_assignable_v<me_std::optional_ref<T>> &&
+    noexcept(std::declval<me_std::optional_ref<T>>().has_value()) &&
+    noexcept(*std::declval<me_std::optional_ref<T>>()) &&
+    noexcept(std::declval<me_std::optional_ref<T>>().operator->()) &&
+    noexcept(std::declval<me_std::optional_ref<T>>().value_or(std::declval<T>())) &&
+    !noexcept(std::declval<me_std::optional_ref<T>>().value());
+
+static_assert(is_noexcept_accessible<int const &>);
+static_assert(is_noexcept_accessible<std::string const &>);
+static_assert(is_noexcept_accessible<int &>);
+static_assert(is_noexcept_accessible<std::string &>);
+
+constexpr std::array<int, 3> lookup_values{42, 42, 43};
+constexpr std::optional<int> lookup_optional{43};
+constexpr std::array<me_std::optional_ref<int const &>, 4> lookup_table{
+    {lookup_values[0], {}, lookup_values[2], lookup_optional}};
+
+static_assert(lookup_table[0].has_value() && !lookup_table[1].has_value());
+static_assert(*lookup_table[0] == 42);
+static_assert(lookup_table[2].value() == 43);
+static_assert(*lookup_table[3].operator->() == 43);
+static_assert(lookup_table[1].value_or(lookup_values[1]) == 42);
+static_assert(lookup_table[1].value_or(7) == 7);
+static_assert(std::optional<int>{lookup_table[0]} == 42);
+static_assert(lookup_table[0] == me_std::optional_ref<int const &>{lookup_values[1]});
+static_assert(lookup_table[1] < lookup_table[0] && lookup_table[0] < lookup_table[2]);
+static_assert(lookup_table[0] != lookup_table[2] && lookup_table[0] <= lookup_table[2]);
+static_assert(lookup_table[2] > lookup_table[1] && lookup_table[2] >= lookup_table[3]);
+static_assert(lookup_table[0] == 42 && 42 == lookup_table[0] && lookup_table[1] != 42);
+static_assert(lookup_table[1] < 42 && 42 < lookup_table[2] && 42 <= lookup_table[0]);
+static_assert(lookup_table[2] > 42 && 43 >= lookup_table[2] && lookup_table[1] <= 0);
+static_assert(!me_std::optional_ref<int const &>{std::nullopt}.has_value());
+
 template <typename T>
 class OptionalRefTest : public ::testing::Test {};
 
@@ -61,8 +116,19 @@ TYPED_TEST_P(OptionalRefTest, OptionalEmptyConstruct) {
   EXPECT_FALSE(test_ref.has_value());
 }
 
+TYPED_TEST_P(OptionalRefTest, NulloptConstruct) {
+  auto test_value = get_value<std::decay_t<TypeParam>>(ValueType::test);
+  me_std::optional_ref<TypeParam> const test_empty_ref{std::nullopt};
+  me_std::optional_ref<TypeParam> test_ref{test_value};
+  EXPECT_FALSE(test_empty_ref.has_value());
+
+  test_ref = std::nullopt;
+  EXPECT_FALSE(test_ref.has_value());
+}
+
 REGISTER_TYPED_TEST_SUITE_P(OptionalRefTest, DefaultConstruct, DefaultValueConstruct,
-                            ValueConstruct, OptionalValueConstruct, OptionalEmptyConstruct);
+                            ValueConstruct, OptionalValueConstruct, OptionalEmptyConstruct,
+                            NulloptConstruct);
 
 INSTANTIATE_TYPED_TEST_SUITE_P(ME, OptionalRefTest, TestTypes);
 
@@ -104,6 +170,40 @@ TYPED_TEST_P(OptionalRefValueTest, Value) {
   EXPECT_EQ(*(this->test_value_ref.operator->()), this->test_value);
 }
 
+TYPED_TEST_P(OptionalRefValueTest, ValueIdentity) {
+  static_assert(std::is_same_v<decltype(*this->test_value_ref), TypeParam>);
+  static_assert(std::is_same_v<decltype(this->test_value_ref.value()), TypeParam>);
+  static_assert(std::is_same_v<decltype(this->test_value_ref.operator->()),
+                               std::remove_reference_t<TypeParam> *>);
+
+  EXPECT_EQ(&this->test_value_ref.value(), &this->test_value);
+  EXPECT_EQ(&*this->test_value_ref, &this->test_value);
+  EXPECT_EQ(this->test_value_ref.operator->(), &this->test_value);
+}
+
+TYPED_TEST_P(OptionalRefValueTest, ValueOr) {
+  std::decay_t<TypeParam> default_value = get_value<std::decay_t<TypeParam>>(ValueType::larger);
+  static_assert(std::is_same_v<decltype(this->test_value_ref.value_or(default_value)), TypeParam>);
+
+  EXPECT_EQ(&this->test_value_ref.value_or(default_value), &this->test_value);
+  EXPECT_EQ(&this->test_empty_ref.value_or(default_value), &default_value);
+
+  EXPECT_EQ(this->test_value_ref.value_or(get_value<std::decay_t<TypeParam>>(ValueType::larger)),
+            this->test_value);
+  EXPECT_EQ(this->test_empty_ref.value_or(get_value<std::decay_t<TypeParam>>(ValueType::larger)),
+            default_value);
+}
+
+TYPED_TEST_P(OptionalRefValueTest, WriteThrough) {
+  if constexpr (!std::is_const_v<std::remove_reference_t<TypeParam>>) {
+    *this->test_value_ref = get_value<std::decay_t<TypeParam>>(ValueType::larger);
+    EXPECT_EQ(this->test_value, get_value<std::decay_t<TypeParam>>(ValueType::larger));
+
+    this->test_value_ref.value() = get_value<std::decay_t<TypeParam>>(ValueType::same);
+    EXPECT_EQ(this->test_value, get_value<std::decay_t<TypeParam>>(ValueType::same));
+  }
+}
+
 TYPED_TEST_P(OptionalRefValueTest, OperatorEQ) {
   EXPECT_TRUE(this->empty_ref == this->test_empty_ref);
   EXPECT_TRUE(this->test_empty_ref == this->empty_ref);
@@ -235,10 +335,351 @@ TYPED_TEST_P(OptionalRefValueTest, ValueToOptional) {
   EXPECT_EQ(test_value.value(), get_value<std::decay_t<TypeParam>>(ValueType::test));
 }
 
-REGISTER_TYPED_TEST_SUITE_P(OptionalRefValueTest, NoValue, Value, OperatorEQ, OperatorNE,
-                            OperatorLT, OperatorLE, OperatorGT, OperatorGE, EmptyToOptional,
-                            ValueToOptional);
+REGISTER_TYPED_TEST_SUITE_P(OptionalRefValueTest, NoValue, Value, ValueIdentity, ValueOr,
+                            WriteThrough, OperatorEQ, OperatorNE, OperatorLT, OperatorLE,
+                            OperatorGT, OperatorGE, EmptyToOptional, ValueToOptional);
 
 INSTANTIATE_TYPED_TEST_SUITE_P(ME, OptionalRefValueTest, TestTypes);
 
+TEST(OptionalRefAccessTest, AccessDoesNotAllocate) {
+  std::string const test_value(1024, 'x');
+  std::string const default_value(1024, 'y');
+  me_std::optional_ref<std::string const &> const test_value_ref{test_value};
+  me_std::optional_ref<std::string const &> const test_empty_ref{};
+
+  auto const allocations_before = me_std::test::allocation_count();
+  auto const size = (*test_value_ref).size() + test_value_ref.value().size() +
+                    test_value_ref->size() + test_value_ref.value_or(default_value).size() +
+                    test_empty_ref.value_or(default_value).size();
+  EXPECT_EQ(allocations_before, me_std::test::allocation_count());
+  EXPECT_EQ(size, 5U * 1024U);
+}
+
+struct shape {
+  shape() = default;
+  shape(shape const &) = delete;
+  shape &operator=(shape const &) = delete;
+  virtual ~shape() = default;
+  virtual int corners() const = 0;
+};
+
+struct square final : shape {
+  int corners() const override { return 4; }
+};
+
+// Owns an object a T & can refer to, and tells objects of it apart.
+template <typename T>
+struct referent;
+
+template <>
+struct referent<shape> {
+  square object{};
+  static int id(shape const &value) { return value.corners(); }
+};
+
+template <>
+struct referent<std::unique_ptr<int>> {
+  std::unique_ptr<int> object{std::make_unique<int>(4)};
+  static int id(std::unique_ptr<int> const &value) { return *value; }
+};
+
+template <>
+struct referent<std::mutex> {
+  std::mutex object{};
+  static int id(std::mutex const &) { return 4; }
+};
+
+template <typename T>
+class OptionalRefReferentTest : public ::testing::Test {
+ protected:
+  using value_type = std::remove_reference_t<T>;
+  referent<std::remove_const_t<value_type>> test_referent{};
+  referent<std::remove_const_t<value_type>> default_referent{};
+};
+
+using ReferentTypes = ::testing::Types<shape const &, shape &, std::unique_ptr<int> const &,
+                                       std::unique_ptr<int> &, std::mutex &>;
+
+static_assert(!std::is_convertible_v<me_std::optional_ref<std::unique_ptr<int> const &>,
+                                     std::optional<std::unique_ptr<int>>>);
+static_assert(!std::is_convertible_v<me_std::optional_ref<std::mutex &>,
+                                     std::optional<std::mutex>>);
+static_assert(std::is_constructible_v<me_std::optional_ref<std::unique_ptr<int> &>,
+                                      std::optional<std::unique_ptr<int>> &>);
+
+TYPED_TEST_SUITE(OptionalRefReferentTest, ReferentTypes);
+
+TYPED_TEST(OptionalRefReferentTest, Dereference) {
+  me_std::optional_ref<TypeParam> const test_ref{this->test_referent.object};
+  me_std::optional_ref<TypeParam> const test_empty_ref{};
+
+  ASSERT_TRUE(test_ref.has_value());
+  EXPECT_FALSE(test_empty_ref.has_value());
+  EXPECT_EQ(&*test_ref, &this->test_referent.object);
+  EXPECT_EQ(test_ref.operator->(), &this->test_referent.object);
+  EXPECT_EQ(&test_ref.value(), &this->test_referent.object);
+  EXPECT_EQ(typeid(*test_ref), typeid(this->test_referent.object));
+  EXPECT_EQ(decltype(this->test_referent)::id(*test_ref), 4);
+}
+
+TYPED_TEST(OptionalRefReferentTest, ValueOr) {
+  me_std::optional_ref<TypeParam> const test_ref{this->test_referent.object};
+  me_std::optional_ref<TypeParam> const test_empty_ref{};
+
+  EXPECT_EQ(&test_ref.value_or(this->default_referent.object), &this->test_referent.object);
+  EXPECT_EQ(&test_empty_ref.value_or(this->default_referent.object),
+            &this->default_referent.object);
+}
+
+TYPED_TEST(OptionalRefReferentTest, Copy) {
+  me_std::optional_ref<TypeParam> test_ref{};
+  me_std::optional_ref<TypeParam> const copy_ref{this->test_referent.object};
+  test_ref = copy_ref;
+
+  EXPECT_EQ(&*test_ref, &*copy_ref);
+}
+
+template <typename Ref, typename V, typename = void>
+struct has_value_or : std::false_type {};
+
+template <typename Ref, typename V>
+struct has_value_or<Ref, V,
+                    std::void_t<decltype(std::declval<Ref const &>().value_or(std::declval<V>()))>>
+    : std::true_type {};
+
+// A temporary default can neither be referred to nor copied out.
+static_assert(has_value_or<me_std::optional_ref<shape const &>, square const &>::value);
+static_assert(!has_value_or<me_std::optional_ref<shape const &>, square>::value);
+static_assert(!has_value_or<me_std::optional_ref<std::unique_ptr<int> const &>,
+                            std::unique_ptr<int>>::value);
+static_assert(has_value_or<me_std::optional_ref<std::string const &>, std::string>::value);
+
+TEST(OptionalRefReferentTest, DynamicType) {
+  square object{};
+  me_std::optional_ref<shape const &> const test_ref{object};
+
+  EXPECT_EQ(typeid(*test_ref), typeid(square));
+  EXPECT_EQ(test_ref->corners(), 4);
+}
+
+// Polymorphic, but neither abstract nor move-only, so copies can be handed out.
+struct polygon {
+  explicit polygon(int corner_count) : corners{corner_count} {}
+  polygon(polygon const &) = default;
+  virtual ~polygon() = default;
+  virtual int kind() const { return 0; }
+  int corners;
+};
+
+struct triangle final : polygon {
+  triangle() : polygon{3} {}
+  int kind() const override { return 3; }
+};
+
+static_assert(has_value_or<me_std::optional_ref<polygon const &>, polygon>::value);
+static_assert(has_value_or<me_std::optional_ref<triangle const &>, triangle>::value);
+static_assert(std::is_convertible_v<me_std::optional_ref<polygon const &>, std::optional<polygon>>);
+
+TEST(OptionalRefReferentTest, ConcretePolymorphicReferent) {
+  polygon const square{4};
+  me_std::optional_ref<polygon const &> const test_ref{square};
+  me_std::optional_ref<triangle const &> const test_empty_ref{};
+
+  std::optional<polygon> const copy = test_ref;
+  ASSERT_TRUE(copy.has_value());
+  EXPECT_EQ(copy->corners, 4);
+  EXPECT_EQ(test_ref.value_or(polygon{5}).corners, 4);
+  auto const fallback = test_empty_ref.value_or(triangle{});
+  EXPECT_EQ(fallback.corners, 3);
+  EXPECT_EQ(fallback.kind(), 3);
+}
+
+TEST(OptionalRefCompareTest, CompatibleTypes) {
+  std::string const test_value{"Hello World"};
+  me_std::optional_ref<std::string const &> const test_value_ref{test_value};
+  me_std::optional_ref<std::string const &> const test_empty_ref{};
+  std::string_view const same_view{"Hello World"};
+  std::string_view const larger_view{"Oh, Hello World"};
+
+  auto const allocations_before = me_std::test::allocation_count();
+  EXPECT_TRUE(test_value_ref == same_view);
+  EXPECT_TRUE(same_view == test_value_ref);
+  EXPECT_TRUE(test_value_ref == "Hello World");
+  EXPECT_TRUE("Hello World" == test_value_ref);
+  EXPECT_TRUE(test_value_ref != larger_view);
+  EXPECT_TRUE(test_value_ref < larger_view);
+  EXPECT_TRUE(test_value_ref <= "Hello World");
+  EXPECT_TRUE(larger_view > test_value_ref);
+  EXPECT_TRUE("Oh, Hello World" >= test_value_ref);
+  EXPECT_FALSE(test_empty_ref == same_view);
+  EXPECT_TRUE(test_empty_ref != "Hello World");
+  EXPECT_TRUE(test_empty_ref < same_view);
+  EXPECT_TRUE(same_view > test_empty_ref);
+  EXPECT_EQ(allocations_before, me_std::test::allocation_count());
+
+  int const number{42};
+  me_std::optional_ref<int const &> const number_ref{number};
+  EXPECT_TRUE(number_ref == 42L);
+  EXPECT_TRUE(number_ref < 42.5);
+}
+
+TEST(OptionalRefCompareTest, StdOptional) {
+  std::string const test_value(1024, 'x');
+  me_std::optional_ref<std::string const &> const test_value_ref{test_value};
+  me_std::optional_ref<std::string const &> const test_empty_ref{};
+  std::optional<std::string> const same_optional{test_value};
+  std::optional<std::string_view> const larger_optional{"y"};
+  std::optional<std::string> const empty_optional{};
+
+  auto const allocations_before = me_std::test::allocation_count();
+  EXPECT_TRUE(test_value_ref == same_optional);
+  EXPECT_TRUE(same_optional == test_value_ref);
+  EXPECT_TRUE(test_value_ref != larger_optional);
+  EXPECT_TRUE(test_value_ref < larger_optional);
+  EXPECT_TRUE(larger_optional >= test_value_ref);
+  EXPECT_TRUE(test_value_ref > empty_optional);
+  EXPECT_TRUE(test_empty_ref == empty_optional);
+  EXPECT_TRUE(empty_optional <= test_empty_ref);
+  EXPECT_FALSE(test_empty_ref < empty_optional);
+  EXPECT_TRUE(test_empty_ref < same_optional);
+  EXPECT_EQ(allocations_before, me_std::test::allocation_count());
+}
+
+struct database {
+  std::string host;
+  std::optional<int> port;
+  std::string const &get_host() const { return host; }
+};
+
+struct config {
+  std::optional<database> db;
+  me_std::optional_ref<database const &> fallback;
+};
+
+TEST(OptionalRefMonadicTest, ProjectionChainDoesNotCopy) {
+  config const test_config{database{std::string(64, 'h'), 8080}, {}};
+  me_std::optional_ref<config const &> const test_ref{test_config};
+  me_std::optional_ref<config const &> const test_empty_ref{};
+
+  auto const allocations_before = me_std::test::allocation_count();
+  auto const host = test_ref.and_then(&config::db).transform(&database::host);
+  auto const getter_host = test_ref.and_then(&config::db).transform(&database::get_host);
+  auto const port = test_ref.and_then(&config::db).and_then(&database::port);
+  auto const empty_host = test_empty_ref.and_then(&config::db).transform(&database::host);
+  auto const fallback_host = test_ref.and_then(&config::fallback).transform(&database::host);
+  EXPECT_EQ(allocations_before, me_std::test::allocation_count());
+
+  static_assert(
+      std::is_same<decltype(host), me_std::optional_ref<std::string const &> const>::value);
+  static_assert(std::is_same<decltype(port), me_std::optional_ref<int const &> const>::value);
+  EXPECT_EQ(&*host, &test_config.db->host);
+  EXPECT_EQ(&*getter_host, &test_config.db->host);
+  EXPECT_EQ(&*port, &*test_config.db->port);
+  EXPECT_FALSE(empty_host.has_value());
+  EXPECT_FALSE(fallback_host.has_value());
+}
+
+TEST(OptionalRefMonadicTest, Transform) {
+  std::string test_value{"Hello World"};
+  me_std::optional_ref<std::string &> const test_ref{test_value};
+  me_std::optional_ref<std::string &> const test_empty_ref{};
+  int calls{0};
+  auto const size = [&calls](std::string const &value) {
+    ++calls;
+    return value.size();
+  };
+
+  auto const test_size = test_ref.transform(size);
+  static_assert(std::is_same<decltype(test_size), std::optional<std::size_t> const>::value);
+  EXPECT_EQ(test_size, 11U);
+  EXPECT_FALSE(test_empty_ref.transform(size).has_value());
+  EXPECT_EQ(calls, 1);
+
+  test_ref.transform([](std::string &value) -> char & { return value[0]; }).value() = 'J';
+  EXPECT_EQ(test_value, "Jello World");
+}
+
+TEST(OptionalRefMonadicTest, AndThen) {
+  std::string const test_value{"Hello World"};
+  me_std::optional_ref<std::string const &> const test_ref{test_value};
+  auto const first_char = [](std::string const &value) {
+    return value.empty() ? me_std::optional_ref<char const &>{}
+                         : me_std::optional_ref<char const &>{value[0]};
+  };
+  auto const parity = [](std::string const &value) {
+    return (value.size() % 2U) == 0U ? std::optional<bool>{} : std::optional<bool>{true};
+  };
+
+  EXPECT_EQ(&*test_ref.and_then(first_char), &test_value[0]);
+  EXPECT_EQ(test_ref.and_then(parity), std::optional<bool>{true});
+  EXPECT_FALSE(me_std::optional_ref<std::string const &>{}.and_then(parity).has_value());
+}
+
+TEST(OptionalRefMonadicTest, OrElse) {
+  int const test_value{42};
+  int const other_value{43};
+  me_std::optional_ref<int const &> const test_ref{test_value};
+  me_std::optional_ref<int const &> const test_empty_ref{};
+  int calls{0};
+  auto const other = [&]() -> int const & {
+    ++calls;
+    return other_value;
+  };
+
+  EXPECT_EQ(&*test_ref.or_else(other), &test_value);
+  EXPECT_EQ(&*test_empty_ref.or_else(other), &other_value);
+  EXPECT_FALSE(test_empty_ref.or_else([] { return me_std::optional_ref<int const &>{}; })
+                   .has_value());
+  EXPECT_EQ(calls, 1);
+
+  std::optional<int> other_optional{44};
+  EXPECT_EQ(&*test_empty_ref.or_else([&]() -> auto & { return other_optional; }),
+            &*other_optional);
+}
+
+template <typename Ref, typename F, typename = void>
+struct has_or_else : std::false_type {};
+
+template <typename Ref, typename F>
+struct has_or_else<Ref, F,
+                   std::void_t<decltype(std::declval<Ref const &>().or_else(std::declval<F>()))>>
+    : std::true_type {};
+
+using int_ref = me_std::optional_ref<int const &>;
+
+// A std::optional or value returned by value would be referred to after it is gone.
+static_assert(has_or_else<int_ref, int_ref (*)()>::value);
+static_assert(has_or_else<int_ref, int const &(*)()>::value);
+static_assert(has_or_else<int_ref, std::optional<int> &(*)()>::value);
+static_assert(!has_or_else<int_ref, std::optional<int> (*)()>::value);
+static_assert(!has_or_else<int_ref, int (*)()>::value);
+
+TEST(OptionalRefMonadicTest, ValueOrElse) {
+  std::string const test_value{"Hello World"};
+  std::string const default_value{"Default"};
+  me_std::optional_ref<std::string const &> const test_ref{test_value};
+  me_std::optional_ref<std::string const &> const test_empty_ref{};
+  int calls{0};
+  auto const make_default = [&calls] {
+    ++calls;
+    return std::string{"Made"};
+  };
+
+  EXPECT_EQ(&test_ref.value_or_else([&]() -> auto & { return default_value; }), &test_value);
+  EXPECT_EQ(&test_empty_ref.value_or_else([&]() -> auto & { return default_value; }),
+            &default_value);
+  static_assert(std::is_same<decltype(test_ref.value_or_else(make_default)), std::string>::value);
+  EXPECT_EQ(test_ref.value_or_else(make_default), "Hello World");
+  EXPECT_EQ(calls, 0);
+  EXPECT_EQ(test_empty_ref.value_or_else(make_default), "Made");
+  EXPECT_EQ(calls, 1);
+}
+
+constexpr int twice(int value) { return 2 * value; }
+
+static_assert(lookup_table[0].transform(twice) == 84);
+static_assert(!lookup_table[1].transform(twice).has_value());
+static_assert(lookup_table[1].or_else([] { return lookup_table[2]; }) == 43);
+static_assert(lookup_table[1].value_or_else([] { return 7; }) == 7);
+
 }  // namespace
@@ -0,0 +1,140 @@
+#include <algorithm>
+#include <me_std/optional_ref.hpp>
+#include <me_std/optional_ref_array.hpp>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace {
+
+TEST(OptionalRefArrayTest, DefaultConstruct) {
+  me_std::optional_ref_array<std::string const &> const test_array{};
+  EXPECT_TRUE(test_array.empty());
+  EXPECT_EQ(test_array.count(), 0U);
+  EXPECT_EQ(test_array.find_next(0U), 0U);
+  EXPECT_EQ(test_array.begin(), test_array.end());
+  EXPECT_EQ(test_array.present().begin(), test_array.present().end());
+}
+
+TEST(OptionalRefArrayTest, SizeConstruct) {
+  me_std::optional_ref_array<int &> const test_array(130U);
+  EXPECT_EQ(test_array.size(), 130U);
+  EXPECT_EQ(test_array.count(), 0U);
+  EXPECT_EQ(test_array.find_next(0U), 130U);
+  EXPECT_TRUE(std::none_of(test_array.begin(), test_array.end(),
+                           [](auto const ref) { return ref.has_value(); }));
+}
+
+TEST(OptionalRefArrayTest, ValueIdentity) {
+  std::string test_value{"Hello World"};
+  std::string other_value{"Oh, Hello World"};
+  me_std::optional_ref_array<std::string &> const test_array{test_value, {}, other_value};
+
+  ASSERT_EQ(test_array.size(), 3U);
+  EXPECT_EQ(&*test_array[0], &test_value);
+  EXPECT_FALSE(test_array[1].has_value());
+  EXPECT_EQ(&*test_array[2], &other_value);
+  EXPECT_TRUE(test_array.has_value(0U));
+  EXPECT_FALSE(test_array.has_value(1U));
+  EXPECT_EQ(test_array.count(), 2U);
+}
+
+TEST(OptionalRefArrayTest, SetAndReset) {
+  std::vector<int> values(200);
+  me_std::optional_ref_array<int const &> test_array(values.size());
+
+  test_array.set(3U, values[3]);
+  test_array.set(64U, values[64]);
+  test_array.set(199U, values[199]);
+  EXPECT_EQ(test_array.count(), 3U);
+  EXPECT_EQ(&*test_array[64], &values[64]);
+
+  test_array.reset(64U);
+  EXPECT_FALSE(test_array[64].has_value());
+  EXPECT_EQ(test_array.count(), 2U);
+
+  test_array.set(3U, {});
+  EXPECT_EQ(test_array.count(), 1U);
+  EXPECT_EQ(test_array.find_next(0U), 199U);
+}
+
+TEST(OptionalRefArrayTest, FindNext) {
+  std::vector<int> values(300);
+  me_std::optional_ref_array<int &> test_array(values.size());
+  for (std::size_t index : {0U, 63U, 64U, 190U, 299U}) {
+    test_array.set(index, values[index]);
+  }
+
+  EXPECT_EQ(test_array.find_next(0U), 0U);
+  EXPECT_EQ(test_array.find_next(1U), 63U);
+  EXPECT_EQ(test_array.find_next(64U), 64U);
+  EXPECT_EQ(test_array.find_next(65U), 190U);
+  EXPECT_EQ(test_array.find_next(191U), 299U);
+  EXPECT_EQ(test_array.find_next(300U), 300U);
+}
+
+TEST(OptionalRefArrayTest, PresentIteration) {
+  std::vector<int> values(300);
+  me_std::optional_ref_array<int &> test_array(values.size());
+  std::vector<std::size_t> const expected{0U, 63U, 64U, 190U, 299U};
+  for (auto const index : expected) {
+    test_array.set(index, values[index]);
+  }
+
+  std::vector<std::size_t> found{};
+  for (auto it = test_array.present().begin(); it != test_array.present().end(); ++it) {
+    EXPECT_EQ(&**it, &values[it.index()]);
+    found.push_back(it.index());
+  }
+  EXPECT_EQ(found, expected);
+}
+
+TEST(OptionalRefArrayTest, PushAndPopBack) {
+  std::vector<int> values(130);
+  me_std::optional_ref_array<int const &> test_array{};
+  for (std::size_t index = 0; index < values.size(); ++index) {
+    test_array.push_back((index % 2U) == 0U ? me_std::optional_ref<int const &>{values[index]}
+                                            : me_std::optional_ref<int const &>{});
+  }
+  EXPECT_EQ(test_array.size(), 130U);
+  EXPECT_EQ(test_array.count(), 65U);
+
+  test_array.pop_back();
+  test_array.pop_back();
+  EXPECT_EQ(test_array.size(), 128U);
+  EXPECT_EQ(test_array.count(), 64U);
+
+  test_array.resize(130U);
+  EXPECT_EQ(test_array.count(), 64U);
+  EXPECT_FALSE(test_array[128].has_value());
+}
+
+TEST(OptionalRefArrayTest, ShrinkClearsPresence) {
+  std::vector<int> values(100);
+  me_std::optional_ref_array<int const &> test_array(values.size());
+  test_array.set(70U, values[70]);
+
+  test_array.resize(65U);
+  test_array.resize(100U);
+  EXPECT_EQ(test_array.count(), 0U);
+  EXPECT_EQ(test_array.find_next(0U), 100U);
+}
+
+TEST(OptionalRefArrayTest, MatchesOptionalRefVector) {
+  std::vector<int> values{1, 2, 3, 4, 5, 6, 7};
+  std::vector<me_std::optional_ref<int const &>> refs{};
+  me_std::optional_ref_array<int const &> test_array{};
+  for (std::size_t index = 0; index < values.size(); ++index) {
+    auto const ref = (index % 3U) == 0U ? me_std::optional_ref<int const &>{}
+                                        : me_std::optional_ref<int const &>{values[index]};
+    refs.push_back(ref);
+    test_array.push_back(ref);
+  }
+
+  EXPECT_TRUE(std::equal(test_array.begin(), test_array.end(), refs.begin(), refs.end()));
+  EXPECT_EQ(test_array.end() - test_array.begin(), static_cast<std::ptrdiff_t>(refs.size()));
+  EXPECT_EQ(test_array.begin()[4], refs[4]);
+}
+
+}  // namespace
@@ -0,0 +1,171 @@
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <limits>
+#include <me_std/optional_ref.hpp>
+#include <me_std/optional_ref_batch.hpp>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace {
+
+template <typename T>
+std::vector<T> make_values(std::size_t count) {
+  std::mt19937 engine{42U};
+  std::uniform_int_distribution<int> distribution{-3, 3};
+  std::vector<T> values{};
+  for (std::size_t index = 0; index < count; ++index) {
+    if constexpr (std::is_same_v<T, std::string>) {
+      values.push_back(std::to_string(distribution(engine)));
+    } else {
+      values.push_back(static_cast<T>(distribution(engine)));
+    }
+  }
+  return values;
+}
+
+// Every third ref is empty, one in seven pairs refers to the same value.
+template <typename T>
+std::vector<me_std::optional_ref<T const &>> make_refs(std::vector<T> const &values,
+                                                       std::size_t offset) {
+  std::vector<me_std::optional_ref<T const &>> refs{};
+  for (std::size_t index = 0; index < values.size(); ++index) {
+    if (((index + offset) % 3U) == 0U) {
+      refs.emplace_back();
+    } else {
+      refs.emplace_back(values[(index % 7U) == 0U ? index : (index + offset) % values.size()]);
+    }
+  }
+  return refs;
+}
+
+template <typename Compare>
+std::vector<std::uint64_t> expected_mask(std::size_t count, Compare compare) {
+  std::vector<std::uint64_t> mask(me_std::batch_mask_size(count), 0U);
+  for (std::size_t index = 0; index < count; ++index) {
+    if (compare(index)) {
+      mask[index / 64U] |= std::uint64_t{1} << (index % 64U);
+    }
+  }
+  return mask;
+}
+
+template <typename T>
+class OptionalRefBatchTest : public ::testing::Test {};
+
+using BatchTypes = ::testing::Types<int, double, std::string>;
+TYPED_TEST_SUITE(OptionalRefBatchTest, BatchTypes);
+
+TYPED_TEST(OptionalRefBatchTest, CompareWithValue) {
+  auto const threshold = make_values<TypeParam>(1U).front();
+  for (std::size_t count : {0U, 1U, 3U, 4U, 5U, 63U, 64U, 67U, 130U, 1000U}) {
+    auto const values = make_values<TypeParam>(count);
+    auto const refs = make_refs(values, 1U);
+    std::vector<std::uint64_t> mask(me_std::batch_mask_size(count), ~std::uint64_t{0});
+
+    me_std::equal_to_mask(refs.data(), count, threshold, mask.data());
+    EXPECT_EQ(mask, expected_mask(count, [&](auto index) { return refs[index] == threshold; }));
+
+    me_std::less_mask(refs.data(), count, threshold, mask.data());
+    EXPECT_EQ(mask, expected_mask(count, [&](auto index) { return refs[index] < threshold; }));
+
+    me_std::greater_mask(refs.data(), count, threshold, mask.data());
+    EXPECT_EQ(mask, expected_mask(count, [&](auto index) { return refs[index] > threshold; }));
+  }
+}
+
+TYPED_TEST(OptionalRefBatchTest, CompareElementwise) {
+  for (std::size_t count : {0U, 1U, 3U, 4U, 5U, 63U, 64U, 67U, 130U, 1000U}) {
+    auto const values = make_values<TypeParam>(count);
+    auto const lhs = make_refs(values, 1U);
+    auto const rhs = make_refs(values, 2U);
+    std::vector<std::uint64_t> mask(me_std::batch_mask_size(count), ~std::uint64_t{0});
+
+    me_std::equal_to_mask(lhs.data(), rhs.data(), count, mask.data());
+    EXPECT_EQ(mask, expected_mask(count, [&](auto index) { return lhs[index] == rhs[index]; }));
+
+    me_std::less_mask(lhs.data(), rhs.data(), count, mask.data());
+    EXPECT_EQ(mask, expected_mask(count, [&](auto index) { return lhs[index] < rhs[index]; }));
+
+    me_std::greater_mask(lhs.data(), rhs.data(), count, mask.data());
+    EXPECT_EQ(mask, expected_mask(count, [&](auto index) { return lhs[index] > rhs[index]; }));
+  }
+}
+
+TYPED_TEST(OptionalRefBatchTest, CompareRanges) {
+  auto const threshold = make_values<TypeParam>(1U).front();
+  auto const values = make_values<TypeParam>(67U);
+  auto const lhs = make_refs(values, 1U);
+  auto const rhs = make_refs(values, 2U);
+  std::vector<std::uint64_t> expected(me_std::batch_mask_size(lhs.size()));
+  std::array<std::uint64_t, 2> mask{};
+
+  me_std::less_mask(lhs.data(), lhs.size(), threshold, expected.data());
+  me_std::less_mask(lhs, threshold, mask);
+  EXPECT_TRUE(std::equal(expected.begin(), expected.end(), mask.begin()));
+
+  me_std::equal_to_mask(lhs.data(), rhs.data(), lhs.size(), expected.data());
+  me_std::equal_to_mask(lhs, rhs, mask);
+  EXPECT_TRUE(std::equal(expected.begin(), expected.end(), mask.begin()));
+
+  me_std::greater_mask(lhs, rhs, expected);
+  EXPECT_EQ(expected,
+            expected_mask(lhs.size(), [&](auto index) { return lhs[index] > rhs[index]; }));
+}
+
+#if defined(ME_STD_BATCH_SSE41)
+// Machines with AVX2 take the AVX2 kernels, so the SSE4.1 ones are called directly.
+template <typename T>
+class OptionalRefBatchSse41Test : public ::testing::Test {};
+
+using SimdTypes = ::testing::Types<int, double>;
+TYPED_TEST_SUITE(OptionalRefBatchSse41Test, SimdTypes);
+
+TYPED_TEST(OptionalRefBatchSse41Test, MatchesOperators) {
+  if (!me_std::detail::has_sse41()) {
+    GTEST_SKIP() << "The CPU does not support SSE4.1.";
+  }
+  using me_std::detail::batch_compare;
+  auto const threshold = make_values<TypeParam>(1U).front();
+  for (std::size_t count : {0U, 3U, 4U, 67U, 130U}) {
+    auto const values = make_values<TypeParam>(count);
+    auto const lhs = make_refs(values, 1U);
+    auto const rhs = make_refs(values, 2U);
+    std::vector<std::uint64_t> mask(me_std::batch_mask_size(count), ~std::uint64_t{0});
+
+    me_std::detail::sse41_mask<batch_compare::equal_to>(lhs.data(), count, threshold, mask.data());
+    EXPECT_EQ(mask, expected_mask(count, [&](auto index) { return lhs[index] == threshold; }));
+    me_std::detail::sse41_mask<batch_compare::less>(lhs.data(), count, threshold, mask.data());
+    EXPECT_EQ(mask, expected_mask(count, [&](auto index) { return lhs[index] < threshold; }));
+    me_std::detail::sse41_mask<batch_compare::greater>(lhs.data(), count, threshold, mask.data());
+    EXPECT_EQ(mask, expected_mask(count, [&](auto index) { return lhs[index] > threshold; }));
+
+    me_std::detail::sse41_mask<batch_compare::equal_to>(lhs.data(), rhs.data(), count,
+                                                        mask.data());
+    EXPECT_EQ(mask, expected_mask(count, [&](auto index) { return lhs[index] == rhs[index]; }));
+    me_std::detail::sse41_mask<batch_compare::less>(lhs.data(), rhs.data(), count, mask.data());
+    EXPECT_EQ(mask, expected_mask(count, [&](auto index) { return lhs[index] < rhs[index]; }));
+    me_std::detail::sse41_mask<batch_compare::greater>(lhs.data(), rhs.data(), count, mask.data());
+    EXPECT_EQ(mask, expected_mask(count, [&](auto index) { return lhs[index] > rhs[index]; }));
+  }
+}
+#endif
+
+TEST(OptionalRefBatchTest, NaNIsNeverOrdered) {
+  std::vector<double> const values{std::numeric_limits<double>::quiet_NaN(), 1.0, 2.0, 3.0};
+  std::vector<me_std::optional_ref<double const &>> const refs{values[0], values[1], {},
+                                                               values[3]};
+  std::vector<std::uint64_t> mask(1U);
+
+  me_std::less_mask(refs.data(), refs.size(), 2.0, mask.data());
+  EXPECT_EQ(mask.front(), 0b0110U);
+  me_std::greater_mask(refs.data(), refs.size(), 2.0, mask.data());
+  EXPECT_EQ(mask.front(), 0b1000U);
+  me_std::equal_to_mask(refs.data(), refs.data(), refs.size(), mask.data());
+  EXPECT_EQ(mask.front(), 0b1111U);
+}
+
+}  // namespace
@@ -0,0 +1,117 @@
+#include <array>
+#include <me_std/optional_span.hpp>
+#include <optional>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace {
+
+// Unchecked, an optional_span is exactly the pointer and size it holds.
+static_assert(sizeof(me_std::optional_span<int>) == (sizeof(int *) + sizeof(std::size_t)));
+static_assert(std::is_trivially_copyable<me_std::optional_span<int const>>::value);
+
+constexpr std::array<int, 3> constexpr_values{1, 2, 3};
+
+static_assert(!me_std::optional_span<int const>{}.has_value());
+static_assert(me_std::optional_span<int const>{constexpr_values}.has_value());
+static_assert(me_std::optional_span<int const>{constexpr_values}.size() == 3U);
+static_assert(me_std::optional_span<int const>{constexpr_values}[1] == 2);
+static_assert(me_std::optional_span<int const>{constexpr_values}.subspan(1U, 2U).front() == 2);
+static_assert(me_std::optional_span<int const>{} < me_std::optional_span{constexpr_values});
+static_assert(me_std::optional_span{constexpr_values} ==
+              me_std::optional_span{constexpr_values}.subspan(0U, 3U));
+
+TEST(OptionalSpanTest, Empty) {
+  me_std::optional_span<int> const span{};
+
+  EXPECT_FALSE(span.has_value());
+  EXPECT_TRUE(span.empty());
+  EXPECT_EQ(span.begin(), span.end());
+  EXPECT_FALSE((me_std::optional_span<int>{nullptr, 3U}.has_value()));
+  EXPECT_EQ((me_std::optional_span<int>{nullptr, 3U}.size()), 0U);
+}
+
+TEST(OptionalSpanTest, Container) {
+  std::vector<int> values{1, 2, 3};
+  me_std::optional_span span{values};
+  static_assert(std::is_same<decltype(span), me_std::optional_span<int>>::value);
+
+  ASSERT_TRUE(span.has_value());
+  EXPECT_EQ(span.data(), values.data());
+  EXPECT_EQ(span.size(), 3U);
+  EXPECT_EQ(span.size_bytes(), 3U * sizeof(int));
+  EXPECT_EQ(span.back(), 3);
+
+  span[0] = 4;
+  EXPECT_EQ(values[0], 4);
+}
+
+TEST(OptionalSpanTest, ConstContainerAndArray) {
+  std::string const text{"text"};
+  int array[] = {1, 2};
+
+  me_std::optional_span const characters{text};
+  me_std::optional_span const numbers{array};
+  static_assert(std::is_same<decltype(characters), me_std::optional_span<char const> const>::value);
+  static_assert(std::is_same<decltype(numbers), me_std::optional_span<int> const>::value);
+  static_assert(!std::is_constructible<me_std::optional_span<char>, std::string const &>::value);
+
+  EXPECT_EQ(characters.size(), 4U);
+  EXPECT_EQ(numbers.data(), array);
+}
+
+TEST(OptionalSpanTest, EmptyContainerIsPresent) {
+  std::vector<int> const values{};
+  me_std::optional_span const span{values};
+
+  EXPECT_TRUE(span.has_value());
+  EXPECT_TRUE(span.empty());
+  EXPECT_NE(span, me_std::optional_span<int const>{});
+}
+
+TEST(OptionalSpanTest, StdOptional) {
+  std::optional<std::vector<int>> present{std::vector<int>{1, 2}};
+  std::optional<std::vector<int>> const absent{};
+
+  me_std::optional_span const span{present};
+  me_std::optional_span const none{absent};
+  static_assert(std::is_same<decltype(span), me_std::optional_span<int> const>::value);
+  static_assert(std::is_same<decltype(none), me_std::optional_span<int const> const>::value);
+
+  EXPECT_EQ(span.data(), present->data());
+  EXPECT_FALSE(none.has_value());
+}
+
+TEST(OptionalSpanTest, ToConst) {
+  std::vector<int> values{1, 2};
+  me_std::optional_span<int> const span{values};
+  me_std::optional_span<int const> const const_span{span};
+  static_assert(!std::is_constructible<me_std::optional_span<int>,
+                                       me_std::optional_span<int const>>::value);
+
+  EXPECT_EQ(const_span.data(), span.data());
+  EXPECT_EQ(const_span, span);
+}
+
+TEST(OptionalSpanTest, Compare) {
+  std::vector<int> const lhs{1, 2, 3};
+  std::array<int, 3> rhs{1, 2, 4};
+  me_std::optional_span<int const> const empty{};
+
+  EXPECT_EQ(empty, empty);
+  EXPECT_NE(empty, me_std::optional_span{lhs});
+  EXPECT_LT(empty, me_std::optional_span{lhs});
+  EXPECT_LT(me_std::optional_span{lhs}, me_std::optional_span{rhs});
+  EXPECT_LT(me_std::optional_span{lhs}.subspan(0U, 2U), me_std::optional_span{lhs});
+  EXPECT_GE(me_std::optional_span{lhs}, empty);
+  EXPECT_GT(me_std::optional_span{rhs}, me_std::optional_span{lhs});
+  EXPECT_LE(me_std::optional_span{lhs}, me_std::optional_span{lhs});
+
+  rhs[2] = 3;
+  EXPECT_EQ(me_std::optional_span{lhs}, me_std::optional_span{rhs});
+}
+
+}  // namespace
@@ -0,0 +1,237 @@
+#include <algorithm>
+#include <cstddef>
+#include <limits>
+#include <me_std/optional_ref.hpp>
+#include <me_std/ref_algorithm.hpp>
+#include <me_std/safe_ref.hpp>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "allocation_count.hpp"
+#include "gtest/gtest.h"
+
+namespace {
+
+// Comparable, but without a ref_sort_key.
+struct unkeyed_value {
+  int value;
+
+  bool operator==(unkeyed_value const &other) const { return value == other.value; }
+  bool operator<(unkeyed_value const &other) const { return value < other.value; }
+};
+
+template <typename T>
+T make_value(std::size_t seed);
+
+template <>
+int make_value<int>(std::size_t seed) {
+  return static_cast<int>(seed % 97U) - 48;
+}
+
+template <>
+double make_value<double>(std::size_t seed) {
+  return (static_cast<double>(seed % 89U) - 44.0) / 8.0;
+}
+
+// Shares long prefixes, so equal keys fall back to comparing the strings.
+template <>
+std::string make_value<std::string>(std::size_t seed) {
+  return std::string(seed % 3U, '\xff') + "prefix-" + std::to_string(seed % 83U);
+}
+
+template <>
+unkeyed_value make_value<unkeyed_value>(std::size_t seed) {
+  return unkeyed_value{static_cast<int>(seed % 61U)};
+}
+
+template <typename T>
+class RefAlgorithmTest : public ::testing::Test {
+ protected:
+  using ref_type = me_std::optional_ref<T const &>;
+
+  RefAlgorithmTest() {
+    for (std::size_t index = 0; index < 1000U; ++index) {
+      m_values.push_back(make_value<T>(index * 7919U));
+    }
+    std::mt19937 generator{42U};
+    for (std::size_t index = 0; index < 1500U; ++index) {
+      auto const pick = generator() % (m_values.size() + 200U);
+      m_refs.push_back((pick < m_values.size()) ? ref_type{m_values[pick]} : ref_type{});
+    }
+  }
+
+  static std::vector<T const *> pointers(std::vector<ref_type> const &refs) {
+    std::vector<T const *> result{};
+    for (auto const ref : refs) {
+      result.push_back(ref.has_value() ? ref.operator->() : nullptr);
+    }
+    return result;
+  }
+
+  std::vector<T> m_values{};
+  std::vector<ref_type> m_refs{};
+};
+
+using sorted_types = ::testing::Types<int, double, std::string, unkeyed_value>;
+TYPED_TEST_SUITE(RefAlgorithmTest, sorted_types);
+
+TYPED_TEST(RefAlgorithmTest, SortMatchesOperatorLess) {
+  auto expected = this->m_refs;
+  std::sort(expected.begin(), expected.end());
+
+  me_std::sort_refs(this->m_refs.begin(), this->m_refs.end());
+
+  EXPECT_TRUE(std::is_sorted(this->m_refs.begin(), this->m_refs.end()));
+  EXPECT_EQ(this->m_refs, expected);
+  EXPECT_FALSE(this->m_refs.front().has_value());
+}
+
+TYPED_TEST(RefAlgorithmTest, StableSortKeepsOrderOfEqualRefs) {
+  auto expected = this->m_refs;
+  std::stable_sort(expected.begin(), expected.end());
+
+  me_std::stable_sort_refs(this->m_refs.begin(), this->m_refs.end());
+
+  EXPECT_EQ(this->pointers(this->m_refs), this->pointers(expected));
+}
+
+TYPED_TEST(RefAlgorithmTest, LowerBoundMatchesStd) {
+  me_std::sort_refs(this->m_refs.begin(), this->m_refs.end());
+
+  for (std::size_t seed = 0; seed < 300U; ++seed) {
+    auto const value = make_value<TypeParam>(seed);
+    auto const expected = std::lower_bound(this->m_refs.begin(), this->m_refs.end(), value);
+    EXPECT_EQ(me_std::lower_bound_refs(this->m_refs.begin(), this->m_refs.end(), value), expected);
+  }
+}
+
+TYPED_TEST(RefAlgorithmTest, EmptyAndSingleRanges) {
+  std::vector<typename TestFixture::ref_type> test_refs{};
+  me_std::sort_refs(test_refs.begin(), test_refs.end());
+  me_std::stable_sort_refs(test_refs.begin(), test_refs.end());
+  auto const value = make_value<TypeParam>(0U);
+  EXPECT_EQ(me_std::lower_bound_refs(test_refs.begin(), test_refs.end(), value), test_refs.end());
+
+  test_refs.emplace_back(value);
+  me_std::sort_refs(test_refs.begin(), test_refs.end());
+  EXPECT_EQ(me_std::lower_bound_refs(test_refs.begin(), test_refs.end(), value), test_refs.begin());
+}
+
+TYPED_TEST(RefAlgorithmTest, SortsSafeRefs) {
+  using safe_ref_type = me_std::safe_ref<TypeParam const &>;
+  std::vector<safe_ref_type> test_refs{};
+  test_refs.reserve(this->m_refs.size());
+  std::vector<TypeParam> expected{};
+  for (auto const ref : this->m_refs) {
+    if (ref.has_value()) {
+      // Every other safe_ref owns a snapshot, the others refer to the value.
+      safe_ref_type const borrowed{*ref};
+      if ((test_refs.size() % 2U) == 0U) {
+        test_refs.push_back(borrowed);
+      } else {
+        test_refs.emplace_back(*ref);
+      }
+      expected.push_back(*ref);
+    }
+  }
+  std::sort(expected.begin(), expected.end());
+
+  auto stable_refs = test_refs;
+  me_std::sort_refs(test_refs.begin(), test_refs.end());
+  me_std::stable_sort_refs(stable_refs.begin(), stable_refs.end());
+
+  ASSERT_EQ(test_refs.size(), expected.size());
+  for (std::size_t index = 0; index < expected.size(); ++index) {
+    EXPECT_EQ(*test_refs[index], expected[index]);
+    EXPECT_EQ(*stable_refs[index], expected[index]);
+  }
+  for (std::size_t seed = 0; seed < 300U; ++seed) {
+    auto const value = make_value<TypeParam>(seed);
+    EXPECT_EQ(me_std::lower_bound_refs(test_refs.begin(), test_refs.end(), value),
+              std::lower_bound(test_refs.begin(), test_refs.end(), value));
+  }
+}
+
+// Snapshots of strings live on the heap, so a moved safe_ref keeps its address.
+TEST(RefAlgorithmSafeRefTest, StableSortKeepsOrderOfEqualRefs) {
+  std::vector<std::string> const values{"b", "a", "b", "c", "a", "b"};
+  std::vector<me_std::safe_ref<std::string const &>> test_refs{};
+  for (auto const &value : values) {
+    me_std::safe_ref<std::string const &> const borrowed{value};
+    test_refs.push_back(borrowed);
+  }
+  std::vector<std::string const *> expected{};
+  for (auto const &ref : test_refs) {
+    expected.push_back(&*ref);
+  }
+  std::stable_sort(expected.begin(), expected.end(),
+                   [](auto const *lhs, auto const *rhs) { return *lhs < *rhs; });
+
+  me_std::stable_sort_refs(test_refs.begin(), test_refs.end());
+
+  for (std::size_t index = 0; index < expected.size(); ++index) {
+    EXPECT_EQ(&*test_refs[index], expected[index]);
+  }
+}
+
+TEST(RefAlgorithmSafeRefTest, SortingBorrowingRefsTakesNoSnapshots) {
+  std::vector<std::string> values{};
+  for (int value = 0; value < 64; ++value) {
+    values.push_back(std::string(32, 'a') + std::to_string((value * 37) % 64));
+  }
+  std::vector<me_std::safe_ref<std::string const &>> test_refs(values.begin(), values.end());
+  std::vector<me_std::safe_ref<std::string const &>> stable_refs(values.begin(), values.end());
+
+  // sort_refs allocates its records, stable_sort_refs the buffer of the
+  // stable sort as well. Neither copies a referent.
+  auto allocations_before = me_std::test::allocation_count();
+  me_std::sort_refs(test_refs.begin(), test_refs.end());
+  EXPECT_LE(me_std::test::allocation_count() - allocations_before, 1U);
+  allocations_before = me_std::test::allocation_count();
+  me_std::stable_sort_refs(stable_refs.begin(), stable_refs.end());
+  EXPECT_LE(me_std::test::allocation_count() - allocations_before, 2U);
+
+  auto const is_borrowed = [&values](auto const &ref) {
+    return (&*ref >= values.data()) && (&*ref < values.data() + values.size());
+  };
+  EXPECT_TRUE(std::is_sorted(test_refs.begin(), test_refs.end()));
+  EXPECT_TRUE(std::is_sorted(stable_refs.begin(), stable_refs.end()));
+  EXPECT_TRUE(std::all_of(test_refs.begin(), test_refs.end(), is_borrowed));
+  EXPECT_TRUE(std::all_of(stable_refs.begin(), stable_refs.end(), is_borrowed));
+}
+
+TEST(RefSortKeyTest, KeysAgreeWithOperatorLess) {
+  std::vector<int> const ints{std::numeric_limits<int>::min(), -1, 0, 1,
+                              std::numeric_limits<int>::max()};
+  EXPECT_TRUE(std::is_sorted(ints.begin(), ints.end(), [](int lhs, int rhs) {
+    return me_std::ref_sort_key<int>::key(lhs) < me_std::ref_sort_key<int>::key(rhs);
+  }));
+
+  std::vector<double> const doubles{-std::numeric_limits<double>::infinity(), -2.5, -0.0, 0.0,
+                                    1e-300, 3.0};
+  EXPECT_TRUE(std::is_sorted(doubles.begin(), doubles.end(), [](double lhs, double rhs) {
+    return me_std::ref_sort_key<double>::key(lhs) < me_std::ref_sort_key<double>::key(rhs);
+  }));
+  EXPECT_EQ(me_std::ref_sort_key<double>::key(-0.0), me_std::ref_sort_key<double>::key(0.0));
+
+  EXPECT_LT(me_std::ref_sort_key<std::string>::key("a"),
+            me_std::ref_sort_key<std::string>::key("\xff"));
+  EXPECT_EQ(me_std::ref_sort_key<std::string>::key("01234567a"),
+            me_std::ref_sort_key<std::string>::key("01234567b"));
+}
+
+TEST(RefAlgorithmWriteTest, SortsMutableRefs) {
+  std::vector<int> values{5, 3, 9, 1};
+  std::vector<me_std::optional_ref<int &>> test_refs{values[0], {}, values[1], values[2],
+                                                     values[3]};
+
+  me_std::sort_refs(test_refs.begin(), test_refs.end());
+
+  EXPECT_FALSE(test_refs[0].has_value());
+  EXPECT_EQ(&*test_refs[1], &values[3]);
+  *test_refs[4] = 10;
+  EXPECT_EQ(values[2], 10);
+}
+
+}  // namespace
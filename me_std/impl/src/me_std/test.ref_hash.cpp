@@ -0,0 +1,163 @@
+#include <functional>
+#include <me_std/optional_ref.hpp>
+#include <me_std/ref_hash.hpp>
+#include <me_std/safe_ref.hpp>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <unordered_set>
+
+#include "allocation_count.hpp"
+#include "gtest/gtest.h"
+
+namespace {
+
+TEST(RefHashTest, HashOfOptionalRef) {
+  std::string const test_value{"Hello World"};
+  me_std::optional_ref<std::string const &> const test_value_ref{test_value};
+  me_std::optional_ref<std::string const &> const test_empty_ref{};
+  me_std::optional_ref<std::string const &> const other_empty_ref{};
+
+  EXPECT_EQ(std::hash<me_std::optional_ref<std::string const &>>{}(test_value_ref),
+            std::hash<std::string>{}(test_value));
+  EXPECT_EQ(std::hash<me_std::optional_ref<std::string const &>>{}(test_empty_ref),
+            std::hash<me_std::optional_ref<std::string const &>>{}(other_empty_ref));
+}
+
+TEST(RefHashTest, HashOfSafeRef) {
+  std::string test_value{"Hello World"};
+  me_std::safe_ref<std::string &> const test_value_ref{test_value};
+  me_std::safe_ref<std::string &> const copy_value_ref{test_value_ref};
+
+  EXPECT_EQ(std::hash<me_std::safe_ref<std::string &>>{}(test_value_ref),
+            std::hash<std::string>{}(test_value));
+  EXPECT_EQ(std::hash<me_std::safe_ref<std::string &>>{}(copy_value_ref),
+            std::hash<std::string>{}(test_value));
+}
+
+TEST(RefHashTest, OptionalRefAsKey) {
+  std::string const test_value{"Hello World"};
+  std::string const same_value{"Hello World"};
+  std::unordered_set<me_std::optional_ref<std::string const &>> keys{};
+
+  EXPECT_TRUE(keys.emplace(test_value).second);
+  EXPECT_TRUE(keys.emplace().second);
+  EXPECT_FALSE(keys.emplace(same_value).second);
+  EXPECT_FALSE(keys.emplace().second);
+  EXPECT_EQ(keys.size(), 2U);
+}
+
+TEST(RefHashTest, TransparentHash) {
+  std::string const test_value{"Hello World"};
+  std::string const same_value{"Hello World"};
+  me_std::ref_hash<std::string> const hash{};
+  auto const expected = std::hash<std::string>{}(test_value);
+
+  EXPECT_EQ(hash(test_value), expected);
+  EXPECT_EQ(hash(me_std::optional_ref<std::string const &>{same_value}), expected);
+  EXPECT_EQ(hash(me_std::safe_ref<std::string const &>{same_value}), expected);
+  EXPECT_EQ(hash(me_std::optional_ref<std::string const &>{}),
+            std::hash<me_std::optional_ref<std::string const &>>{}({}));
+}
+
+TEST(RefHashTest, TransparentEqualTo) {
+  std::string test_value{"Hello World"};
+  std::string const same_value{"Hello World"};
+  std::string const other_value{"Oh, Hello World"};
+  me_std::ref_equal_to<std::string> const equal_to{};
+
+  me_std::optional_ref<std::string &> const test_value_ref{test_value};
+  me_std::optional_ref<std::string const &> const test_empty_ref{};
+  me_std::safe_ref<std::string const &> const same_value_ref{same_value};
+  me_std::safe_ref<std::string const &> const other_value_ref{other_value};
+
+  EXPECT_TRUE(equal_to(test_value_ref, same_value_ref));
+  EXPECT_TRUE(equal_to(same_value_ref, test_value_ref));
+  EXPECT_TRUE(equal_to(test_value, same_value_ref));
+  EXPECT_TRUE(equal_to(test_value_ref, same_value));
+  EXPECT_TRUE(equal_to(test_empty_ref, me_std::optional_ref<std::string &>{}));
+
+  EXPECT_FALSE(equal_to(test_value_ref, other_value_ref));
+  EXPECT_FALSE(equal_to(other_value, test_value_ref));
+  EXPECT_FALSE(equal_to(test_empty_ref, test_value));
+  EXPECT_FALSE(equal_to(same_value_ref, test_empty_ref));
+}
+
+TEST(RefHashTest, ConvertibleKey) {
+  std::string const test_value{"Hello World"};
+  me_std::ref_hash<std::string> const hash{};
+  me_std::ref_equal_to<std::string> const equal_to{};
+
+  EXPECT_EQ(hash("Hello World"), std::hash<std::string>{}(test_value));
+  EXPECT_EQ(hash(test_value.c_str()), std::hash<std::string>{}(test_value));
+  EXPECT_TRUE(equal_to("Hello World", test_value));
+  EXPECT_TRUE(equal_to(me_std::optional_ref<std::string const &>{test_value}, "Hello World"));
+  EXPECT_FALSE(equal_to(me_std::optional_ref<std::string const &>{}, "Hello World"));
+  EXPECT_FALSE(equal_to(test_value, "Oh, Hello World"));
+}
+
+TEST(RefHashTest, StringKeysDoNotAllocate) {
+  std::string const test_value(1024, 'x');
+  std::string_view const test_view{test_value};
+  me_std::ref_hash<std::string> const hash{};
+  me_std::ref_equal_to<std::string> const equal_to{};
+  auto const expected_hash = std::hash<std::string>{}(test_value);
+
+  auto const allocations_before = me_std::test::allocation_count();
+  auto const view_hash = hash(test_view);
+  auto const pointer_hash = hash(test_value.c_str());
+  auto const view_equal = equal_to(test_value, test_view);
+  auto const pointer_equal = equal_to(test_value.c_str(), test_value);
+  auto const keys_equal = equal_to(test_view, "x");
+  auto const empty_equal = equal_to(me_std::optional_ref<std::string const &>{}, test_view);
+  EXPECT_EQ(allocations_before, me_std::test::allocation_count());
+
+  EXPECT_EQ(view_hash, expected_hash);
+  EXPECT_EQ(pointer_hash, expected_hash);
+  EXPECT_TRUE(view_equal);
+  EXPECT_TRUE(pointer_equal);
+  EXPECT_FALSE(keys_equal);
+  EXPECT_FALSE(empty_equal);
+}
+
+#if defined(__cpp_lib_generic_unordered_lookup)
+TEST(RefHashTest, FindByConvertibleKey) {
+  std::string const test_value{"Hello World"};
+  std::string const other_value{"Oh, Hello World"};
+  std::unordered_set<std::reference_wrapper<std::string const>, me_std::ref_hash<std::string>,
+                     me_std::ref_equal_to<std::string>> const keys{std::cref(test_value)};
+
+  auto const found = keys.find(std::string{"Hello World"}.c_str());
+  ASSERT_NE(found, keys.end());
+  EXPECT_EQ(&found->get(), &test_value);
+  EXPECT_NE(keys.find("Hello World"), keys.end());
+  EXPECT_EQ(keys.find(other_value.c_str()), keys.end());
+}
+
+TEST(RefHashTest, HeterogeneousFindDoesNotAllocate) {
+  std::unordered_map<std::string, int, me_std::ref_hash<std::string>,
+                     me_std::ref_equal_to<std::string>> const map{{std::string(1024, 'x'), 42}};
+  std::string const test_value(1024, 'x');
+  std::string const other_value(1024, 'y');
+  me_std::optional_ref<std::string const &> const test_value_ref{test_value};
+  me_std::optional_ref<std::string const &> const test_empty_ref{};
+  me_std::safe_ref<std::string const &> const other_value_ref{other_value};
+
+  auto const allocations_before = me_std::test::allocation_count();
+  auto const found = map.find(test_value_ref);
+  auto const found_empty = map.find(test_empty_ref);
+  auto const found_other = map.find(other_value_ref);
+  auto const found_view = map.find(std::string_view{test_value});
+  auto const found_pointer = map.find(test_value.c_str());
+  EXPECT_EQ(allocations_before, me_std::test::allocation_count());
+
+  ASSERT_NE(found, map.end());
+  EXPECT_EQ(found->second, 42);
+  EXPECT_EQ(found_empty, map.end());
+  EXPECT_EQ(found_other, map.end());
+  EXPECT_EQ(found_view, found);
+  EXPECT_EQ(found_pointer, found);
+}
+#endif
+
+}  // namespace
@@ -0,0 +1,83 @@
+#include <algorithm>
+#include <me_std/ref_views.hpp>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "allocation_count.hpp"
+#include "gtest/gtest.h"
+
+#if defined(__cpp_lib_ranges)
+
+namespace {
+
+TEST(RefViewsTest, PresentAndDeref) {
+  std::vector<int> values{1, 2, 3};
+  std::vector<me_std::optional_ref<int &>> const refs{values[0], {}, values[1], {}, values[2]};
+
+  auto present_values = refs | me_std::views::present | me_std::views::deref;
+  static_assert(
+      std::is_same<std::ranges::range_reference_t<decltype(present_values)>, int &>::value);
+
+  auto const allocations_before = me_std::test::allocation_count();
+  int sum{0};
+  for (int &value : present_values) {
+    sum += value;
+    value *= 10;
+  }
+  EXPECT_EQ(allocations_before, me_std::test::allocation_count());
+
+  EXPECT_EQ(sum, 6);
+  EXPECT_EQ(values, (std::vector<int>{10, 20, 30}));
+  EXPECT_EQ(std::ranges::distance(refs | me_std::views::present), 3);
+  EXPECT_EQ(&*std::ranges::begin(present_values), &values[0]);
+}
+
+TEST(RefViewsTest, ComposesWithStdViews) {
+  std::vector<std::string> const values{"one", "two", "three"};
+  std::vector<me_std::optional_ref<std::string const &>> const refs{{}, values[0], values[2]};
+
+  auto sizes = refs | me_std::views::present | me_std::views::deref |
+               std::views::transform([](std::string const &value) { return value.size(); });
+
+  EXPECT_EQ(std::ranges::distance(sizes), 2);
+  EXPECT_EQ(*std::ranges::begin(sizes), 3U);
+  EXPECT_EQ(std::ranges::count_if(refs | me_std::views::present,
+                                  [](auto ref) { return ref == "three"; }),
+            1);
+}
+
+TEST(RefViewsTest, StdOptionalRange) {
+  std::vector<std::optional<std::string>> optionals{std::string{"one"}, std::nullopt,
+                                                    std::string{"two"}};
+
+  auto refs = optionals | me_std::views::as_optional_ref;
+  static_assert(std::is_same<std::ranges::range_value_t<decltype(refs)>,
+                             me_std::optional_ref<std::string &>>::value);
+
+  std::vector<std::string const *> addresses{};
+  for (std::string &value : refs | me_std::views::present | me_std::views::deref) {
+    addresses.push_back(&value);
+  }
+  EXPECT_EQ(addresses, (std::vector<std::string const *>{&*optionals[0], &*optionals[2]}));
+  EXPECT_EQ(std::ranges::distance(optionals | me_std::views::present), 2);
+}
+
+TEST(RefViewsTest, PointerRange) {
+  int const first{1};
+  int const second{2};
+  std::vector<int const *> const pointers{&first, nullptr, &second};
+
+  auto refs = pointers | me_std::views::as_optional_ref;
+  static_assert(std::is_same<std::ranges::range_value_t<decltype(refs)>,
+                             me_std::optional_ref<int const &>>::value);
+
+  auto iterator = std::ranges::begin(refs);
+  EXPECT_EQ(&**iterator, &first);
+  EXPECT_FALSE((*++iterator).has_value());
+  EXPECT_EQ(&**++iterator, &second);
+}
+
+}  // namespace
+
+#endif
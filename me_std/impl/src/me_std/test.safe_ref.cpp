@@ -1,8 +1,16 @@
+#include <algorithm>
 #include <array>
+#include <cstddef>
 #include <me_std/safe_ref.hpp>
 #include <memory>
+#include <memory_resource>
+#include <optional>
 #include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
 
+#include "allocation_count.hpp"
 #include "gtest/gtest.h"
 
 namespace {
@@ -60,8 +68,9 @@ TYPED_TEST_P(SafeRefTest, MoveConstruct) {
   std::unique_ptr<me_std::safe_ref<TypeParam>> move_test_ref{};
   {
     auto test_copy_value = test_value;
-    me_std::safe_ref<TypeParam> test_ref{test_copy_value};
-    move_test_ref = std::make_unique<me_std::safe_ref<TypeParam>>(std::move(test_ref));
+    me_std::safe_ref<TypeParam> const test_ref{test_copy_value};
+    me_std::safe_ref<TypeParam> copy_test_ref{test_ref};
+    move_test_ref = std::make_unique<me_std::safe_ref<TypeParam>>(std::move(copy_test_ref));
   }
   EXPECT_EQ(test_value, **move_test_ref);
 }
@@ -176,9 +185,503 @@ TYPED_TEST_P(SafeRefValueTest, OperatorGE) {
   EXPECT_FALSE(this->test_value_ref >= this->larger_value);
 }
 
+TYPED_TEST_P(SafeRefValueTest, ComparisonDoesNotAllocate) {
+  auto const allocations_before = me_std::test::allocation_count();
+  auto const results = std::array<bool, 18>{
+      this->test_value_ref == this->same_value_ref, this->test_value_ref != this->other_value_ref,
+      this->test_value_ref < this->larger_value_ref, this->test_value_ref <= this->same_value_ref,
+      this->larger_value_ref > this->test_value_ref, this->test_value_ref >= this->same_value_ref,
+      this->test_value_ref == this->same_value,     this->same_value == this->test_value_ref,
+      this->test_value_ref != this->other_value,    this->other_value != this->test_value_ref,
+      this->test_value_ref < this->larger_value,    this->test_value < this->larger_value_ref,
+      this->test_value_ref <= this->same_value,     this->same_value <= this->test_value_ref,
+      this->larger_value_ref > this->test_value,    this->larger_value > this->test_value_ref,
+      this->test_value_ref >= this->same_value,     this->same_value >= this->test_value_ref};
+  auto const allocations_after = me_std::test::allocation_count();
+
+  EXPECT_EQ(allocations_before, allocations_after);
+  for (auto const result : results) {
+    EXPECT_TRUE(result);
+  }
+}
+
 REGISTER_TYPED_TEST_SUITE_P(SafeRefValueTest, Value, OperatorEQ, OperatorNE, OperatorLT, OperatorLE,
-                            OperatorGT, OperatorGE);
+                            OperatorGT, OperatorGE, ComparisonDoesNotAllocate);
 
 INSTANTIATE_TYPED_TEST_SUITE_P(ME, SafeRefValueTest, TestTypes);
 
+struct small_value {
+  std::array<int, 2> values;
+  bool operator==(small_value const &other) const { return values == other.values; }
+};
+
+struct inline_value {
+  std::array<int, 16> values;
+  bool operator==(inline_value const &other) const { return values == other.values; }
+};
+
+// Counts its copies, moves are free.
+template <me_std::safe_ref_storage Storage>
+struct counted_value {
+  static inline std::size_t copies{0};
+
+  explicit counted_value(int v) : value{v} {}
+  counted_value(counted_value const &other) : value{other.value} { ++copies; }
+  counted_value(counted_value &&other) noexcept = default;
+
+  bool operator==(counted_value const &other) const { return value == other.value; }
+  bool operator<(counted_value const &other) const { return value < other.value; }
+
+  int value;
+};
+
+}  // namespace
+
+template <me_std::safe_ref_storage Storage>
+struct me_std::safe_ref_storage_traits<counted_value<Storage>> {
+  static constexpr auto storage = Storage;
+};
+
+template <>
+struct me_std::safe_ref_storage_traits<small_value> {
+  static constexpr auto storage = me_std::safe_ref_storage::heap;
+};
+
+template <>
+struct me_std::safe_ref_storage_traits<inline_value> {
+  static constexpr auto storage = me_std::safe_ref_storage::inline_buffer;
+};
+
+template <>
+struct me_std::safe_ref_storage_traits<std::vector<int>> {
+  static constexpr auto storage = me_std::safe_ref_storage::shared;
+};
+
+namespace {
+
+template <typename T>
+constexpr bool stores_inline =
+    me_std::safe_ref<T>::storage == me_std::safe_ref_storage::inline_buffer;
+
+static_assert(stores_inline<int const &>);
+static_assert(stores_inline<double &>);
+static_assert(!stores_inline<std::string const &>);
+static_assert(!stores_inline<small_value const &>);
+static_assert(stores_inline<inline_value const &>);
+static_assert(me_std::safe_ref<std::vector<int> const &>::storage ==
+              me_std::safe_ref_storage::shared);
+static_assert(me_std::safe_ref<std::vector<int> &>::storage == me_std::safe_ref_storage::heap);
+
+template <typename T>
+std::size_t copy_allocations(T const &value) {
+  me_std::safe_ref<T const &> const test_ref{value};
+  auto const allocations_before = me_std::test::allocation_count();
+  me_std::safe_ref<T const &> const copy_ref{test_ref};
+  auto const allocations = me_std::test::allocation_count() - allocations_before;
+
+  auto const *const copy_begin = reinterpret_cast<unsigned char const *>(&copy_ref);
+  auto const *const value_begin = reinterpret_cast<unsigned char const *>(&*copy_ref);
+  auto const stored_inline =
+      (value_begin >= copy_begin) && (value_begin < copy_begin + sizeof(copy_ref));
+  EXPECT_EQ(stored_inline, stores_inline<T const &>);
+  EXPECT_EQ(*copy_ref, value);
+  return allocations;
+}
+
+TEST(SafeRefStorageTest, SmallValuesCopyInline) {
+  EXPECT_EQ(copy_allocations(42), 0U);
+  EXPECT_EQ(copy_allocations(small_value{{4, 2}}), 1U);
+  EXPECT_EQ(copy_allocations(inline_value{{4, 2}}), 0U);
+  EXPECT_EQ(copy_allocations(std::string(1024, 'x')), 2U);
+}
+
+TEST(SafeRefStorageTest, InlineCopyOfCopy) {
+  std::unique_ptr<me_std::safe_ref<int const &>> copy_copy_ref{};
+  {
+    int const test_value{42};
+    me_std::safe_ref<int const &> const test_ref{test_value};
+    me_std::safe_ref<int const &> const copy_ref{test_ref};
+    copy_copy_ref = std::make_unique<me_std::safe_ref<int const &>>(copy_ref);
+  }
+  EXPECT_EQ(**copy_copy_ref, 42);
+}
+
+TEST(SafeRefStorageTest, SharedSnapshot) {
+  std::vector<int> const test_value(1024, 42);
+  me_std::safe_ref<std::vector<int> const &> const test_ref{test_value};
+  EXPECT_EQ(test_ref.use_count(), 0);
+
+  auto const allocations_before = me_std::test::allocation_count();
+  me_std::safe_ref<std::vector<int> const &> const copy_ref{test_ref};
+  auto const allocations_after_snapshot = me_std::test::allocation_count();
+  me_std::safe_ref<std::vector<int> const &> const copy_copy_ref{copy_ref};
+  me_std::safe_ref<std::vector<int> const &> const copy_copy_copy_ref{copy_copy_ref};
+
+  EXPECT_EQ(allocations_after_snapshot - allocations_before, 2U);
+  EXPECT_EQ(allocations_after_snapshot, me_std::test::allocation_count());
+  EXPECT_NE(&*copy_ref, &test_value);
+  EXPECT_EQ(&*copy_copy_ref, &*copy_ref);
+  EXPECT_EQ(&*copy_copy_copy_ref, &*copy_ref);
+  EXPECT_EQ(copy_ref.use_count(), 3);
+}
+
+TEST(SafeRefStorageTest, SharedSnapshotAcrossThreads) {
+  std::unique_ptr<me_std::safe_ref<std::vector<int> const &>> copy_ref{};
+  {
+    std::vector<int> const test_value(1024, 42);
+    me_std::safe_ref<std::vector<int> const &> const test_ref{test_value};
+    copy_ref = std::make_unique<me_std::safe_ref<std::vector<int> const &>>(test_ref);
+  }
+
+  std::vector<std::thread> consumers{};
+  std::array<long, 8> sums{};
+  for (auto &sum : sums) {
+    consumers.emplace_back([&copy_ref, &sum] {
+      for (int copy = 0; copy < 1000; ++copy) {
+        me_std::safe_ref<std::vector<int> const &> const consumer_ref{*copy_ref};
+        sum += (*consumer_ref)[static_cast<std::size_t>(copy)];
+      }
+    });
+  }
+  for (auto &consumer : consumers) {
+    consumer.join();
+  }
+
+  EXPECT_EQ(copy_ref->use_count(), 1);
+  for (auto const sum : sums) {
+    EXPECT_EQ(sum, 42000);
+  }
+}
+
+template <typename T>
+class SafeRefMoveTest : public ::testing::Test {};
+
+using StorageTypes =
+    ::testing::Types<counted_value<me_std::safe_ref_storage::heap>,
+                     counted_value<me_std::safe_ref_storage::inline_buffer>,
+                     counted_value<me_std::safe_ref_storage::shared>>;
+TYPED_TEST_SUITE(SafeRefMoveTest, StorageTypes);
+
+template <typename T>
+me_std::safe_ref<T const &> make_copy(me_std::safe_ref<T const &> const &ref) {
+  me_std::safe_ref<T const &> copy{ref};
+  return copy;
+}
+
+TYPED_TEST(SafeRefMoveTest, MoveDoesNotCopy) {
+  TypeParam const test_value{42};
+  me_std::safe_ref<TypeParam const &> const test_ref{test_value};
+  me_std::safe_ref<TypeParam const &> copy_ref{test_ref};
+  auto const *const snapshot = &*copy_ref;
+  std::vector<me_std::safe_ref<TypeParam const &>> refs{};
+  refs.reserve(2);
+  TypeParam::copies = 0;
+
+  auto const allocations_before = me_std::test::allocation_count();
+  me_std::safe_ref<TypeParam const &> move_ref{std::move(copy_ref)};
+  refs.push_back(std::move(move_ref));
+  auto const allocations_after = me_std::test::allocation_count();
+
+  EXPECT_EQ(allocations_before, allocations_after);
+  EXPECT_EQ(TypeParam::copies, 0U);
+  EXPECT_EQ((*refs.front()).value, 42);
+  if constexpr (me_std::safe_ref<TypeParam const &>::storage !=
+                me_std::safe_ref_storage::inline_buffer) {
+    EXPECT_EQ(&*refs.front(), snapshot);
+  } else {
+    EXPECT_NE(&*refs.front(), snapshot);
+  }
+
+  refs.push_back(make_copy(refs.front()));
+  auto const shared =
+      me_std::safe_ref<TypeParam const &>::storage == me_std::safe_ref_storage::shared;
+  EXPECT_EQ(TypeParam::copies, shared ? 0U : 1U);
+  EXPECT_EQ((*refs.back()).value, 42);
+}
+
+TYPED_TEST(SafeRefMoveTest, MoveOfReferenceDoesNotCopy) {
+  TypeParam const test_value{42};
+  me_std::safe_ref<TypeParam const &> test_ref{test_value};
+  TypeParam::copies = 0;
+
+  auto const allocations_before = me_std::test::allocation_count();
+  me_std::safe_ref<TypeParam const &> const move_ref{std::move(test_ref)};
+
+  EXPECT_EQ(allocations_before, me_std::test::allocation_count());
+  EXPECT_EQ(TypeParam::copies, 0U);
+  EXPECT_EQ(&*move_ref, &test_value);
+}
+
+TYPED_TEST(SafeRefMoveTest, ValueConstructTakesOwnership) {
+  TypeParam::copies = 0;
+  me_std::safe_ref<TypeParam const &> test_ref{TypeParam{42}};
+  me_std::safe_ref<TypeParam const &> const move_ref{std::move(test_ref)};
+
+  EXPECT_EQ(TypeParam::copies, 0U);
+  EXPECT_EQ((*move_ref).value, 42);
+}
+
+TEST(SafeRefMoveTest, ValueConstructWithAllocator) {
+  std::pmr::monotonic_buffer_resource resource{};
+  me_std::pmr::safe_ref<std::pmr::string const &> test_ref{std::pmr::string(1024, 'x'),
+                                                           &resource};
+  me_std::pmr::safe_ref<std::pmr::string const &> const move_ref{std::move(test_ref)};
+
+  EXPECT_EQ(move_ref.get_allocator().resource(), &resource);
+  EXPECT_EQ(*move_ref, std::pmr::string(1024, 'x'));
+}
+
+class counting_resource : public std::pmr::memory_resource {
+ public:
+  std::size_t allocations{0};
+  std::size_t deallocations{0};
+
+ private:
+  void *do_allocate(std::size_t bytes, std::size_t alignment) override {
+    ++allocations;
+    return m_upstream.allocate(bytes, alignment);
+  }
+  void do_deallocate(void *memory, std::size_t bytes, std::size_t alignment) override {
+    ++deallocations;
+    m_upstream.deallocate(memory, bytes, alignment);
+  }
+  bool do_is_equal(std::pmr::memory_resource const &other) const noexcept override {
+    return this == &other;
+  }
+
+  // Backed by a buffer, so allocations from the resource never reach the
+  // global operator new.
+  alignas(std::max_align_t) unsigned char m_buffer[16384];
+  std::pmr::monotonic_buffer_resource m_upstream{m_buffer, sizeof(m_buffer),
+                                                 std::pmr::null_memory_resource()};
+};
+
+TYPED_TEST(SafeRefMoveTest, CopyAssignRebinds) {
+  TypeParam const test_value{42};
+  TypeParam const other_value{43};
+  me_std::safe_ref<TypeParam const &> test_ref{test_value};
+  me_std::safe_ref<TypeParam const &> const other_ref{other_value};
+
+  TypeParam::copies = 0;
+  test_ref = other_ref;
+
+  EXPECT_EQ(TypeParam::copies, 1U);
+  EXPECT_EQ((*test_ref).value, 43);
+  EXPECT_NE(&*test_ref, &other_value);
+  EXPECT_EQ(&*other_ref, &other_value);
+}
+
+TYPED_TEST(SafeRefMoveTest, MoveAssignDoesNotCopy) {
+  TypeParam const test_value{42};
+  me_std::safe_ref<TypeParam const &> const test_ref{test_value};
+  me_std::safe_ref<TypeParam const &> copy_ref{test_ref};
+  auto const *const snapshot = &*copy_ref;
+  me_std::safe_ref<TypeParam const &> target_ref{TypeParam{43}};
+  TypeParam::copies = 0;
+
+  auto const allocations_before = me_std::test::allocation_count();
+  target_ref = std::move(copy_ref);
+
+  EXPECT_EQ(allocations_before, me_std::test::allocation_count());
+  EXPECT_EQ(TypeParam::copies, 0U);
+  EXPECT_EQ((*target_ref).value, 42);
+  if constexpr (me_std::safe_ref<TypeParam const &>::storage !=
+                me_std::safe_ref_storage::inline_buffer) {
+    EXPECT_EQ(&*target_ref, snapshot);
+  }
+
+  target_ref = me_std::safe_ref<TypeParam const &>{test_value};
+  EXPECT_EQ(&*target_ref, &test_value);
+}
+
+static_assert(std::is_nothrow_move_constructible_v<me_std::safe_ref<std::string const &>>);
+static_assert(std::is_nothrow_move_constructible_v<me_std::safe_ref<std::vector<int> const &>>);
+
+TYPED_TEST(SafeRefMoveTest, ContainerOperationsDoNotCopy) {
+  static_assert(std::is_nothrow_move_constructible_v<me_std::safe_ref<TypeParam const &>>);
+  std::vector<TypeParam> values{};
+  for (int value = 0; value < 64; ++value) {
+    values.emplace_back((value * 37) % 64);
+  }
+  std::vector<me_std::safe_ref<TypeParam const &>> refs{};
+  for (auto const &value : values) {
+    me_std::safe_ref<TypeParam const &> const test_ref{value};
+    refs.emplace_back(test_ref);
+  }
+  refs.shrink_to_fit();
+  me_std::safe_ref<TypeParam const &> back_ref{refs.back()};
+  std::vector<TypeParam const *> snapshots{};
+  for (auto const &ref : refs) {
+    snapshots.push_back(&*ref);
+  }
+  TypeParam::copies = 0;
+
+  // Growing past the capacity allocates the new buffer and moves the owning
+  // refs into it. Snapshots outside of the safe_ref stay where they are.
+  auto const allocations_before = me_std::test::allocation_count();
+  refs.push_back(std::move(back_ref));
+  EXPECT_EQ(me_std::test::allocation_count() - allocations_before, 1U);
+  EXPECT_EQ(TypeParam::copies, 0U);
+  if (me_std::safe_ref<TypeParam const &>::storage != me_std::safe_ref_storage::inline_buffer) {
+    for (std::size_t index = 0; index < snapshots.size(); ++index) {
+      EXPECT_EQ(&*refs[index], snapshots[index]);
+    }
+  }
+
+  auto const allocations_grown = me_std::test::allocation_count();
+  std::sort(refs.begin(), refs.end());
+  refs.erase(refs.begin(), refs.begin() + 8);
+  refs.insert(refs.begin(), me_std::safe_ref<TypeParam const &>{values.front()});
+  auto const allocations_after = me_std::test::allocation_count();
+
+  EXPECT_EQ(TypeParam::copies, 0U);
+  EXPECT_EQ(allocations_grown, allocations_after);
+  EXPECT_TRUE(std::is_sorted(refs.begin() + 1, refs.end()));
+  EXPECT_EQ(&*refs.front(), &values.front());
+}
+
+TEST(SafeRefMoveTest, MoveAssignAcrossResources) {
+  counting_resource resource{};
+  std::pmr::string const test_value(1024, 'x');
+  me_std::pmr::safe_ref<std::pmr::string const &> const test_ref{test_value};
+  me_std::pmr::safe_ref<std::pmr::string const &> copy_ref{test_ref};
+  me_std::pmr::safe_ref<std::pmr::string const &> target_ref{test_value, &resource};
+
+  target_ref = std::move(copy_ref);
+
+  EXPECT_EQ(target_ref.get_allocator().resource(), &resource);
+  EXPECT_EQ(resource.allocations, 2U);
+  EXPECT_EQ(*target_ref, test_value);
+}
+
+static_assert(me_std::is_trivially_relocatable_v<me_std::safe_ref<std::string const &>>);
+static_assert(me_std::is_trivially_relocatable_v<me_std::safe_ref<std::vector<int> const &>>);
+static_assert(!me_std::is_trivially_relocatable_v<me_std::safe_ref<int const &>>);
+
+TEST(SafeRefMoveTest, Relocate) {
+  std::string const test_value(1024, 'x');
+  me_std::safe_ref<std::string const &> const test_ref{test_value};
+  alignas(me_std::safe_ref<std::string const &>) unsigned char
+      source[2 * sizeof(me_std::safe_ref<std::string const &>)];
+  alignas(me_std::safe_ref<std::string const &>) unsigned char
+      destination[2 * sizeof(me_std::safe_ref<std::string const &>)];
+  auto *const first = reinterpret_cast<me_std::safe_ref<std::string const &> *>(source);
+  ::new (static_cast<void *>(first)) me_std::safe_ref<std::string const &>{test_ref};
+  ::new (static_cast<void *>(first + 1)) me_std::safe_ref<std::string const &>{test_value};
+  auto const *const snapshot = &**first;
+
+  auto const allocations_before = me_std::test::allocation_count();
+  auto *const relocated = reinterpret_cast<me_std::safe_ref<std::string const &> *>(destination);
+  auto *const end = me_std::uninitialized_relocate(first, first + 2, relocated);
+
+  EXPECT_EQ(allocations_before, me_std::test::allocation_count());
+  EXPECT_EQ(end, relocated + 2);
+  EXPECT_EQ(&*relocated[0], snapshot);
+  EXPECT_EQ(&*relocated[1], &test_value);
+  std::destroy(relocated, end);
+}
+
+TEST(SafeRefMoveTest, RelocateInline) {
+  int const test_value{42};
+  me_std::safe_ref<int const &> const test_ref{test_value};
+  alignas(me_std::safe_ref<int const &>) unsigned char source[sizeof(test_ref)];
+  alignas(me_std::safe_ref<int const &>) unsigned char destination[sizeof(test_ref)];
+  auto *const first = reinterpret_cast<me_std::safe_ref<int const &> *>(source);
+  ::new (static_cast<void *>(first)) me_std::safe_ref<int const &>{test_ref};
+
+  auto *const relocated = reinterpret_cast<me_std::safe_ref<int const &> *>(destination);
+  auto *const end = me_std::uninitialized_relocate(first, first + 1, relocated);
+
+  auto const *const relocated_begin = reinterpret_cast<unsigned char const *>(relocated);
+  auto const *const value_begin = reinterpret_cast<unsigned char const *>(&**relocated);
+  EXPECT_TRUE((value_begin >= relocated_begin) &&
+              (value_begin < relocated_begin + sizeof(test_ref)));
+  EXPECT_EQ(**relocated, 42);
+  std::destroy(relocated, end);
+}
+
+TEST(SafeRefAllocatorTest, DefaultAllocatorKeepsLayout) {
+  EXPECT_EQ(sizeof(me_std::safe_ref<std::string const &>),
+            sizeof(std::unique_ptr<std::string>) + sizeof(std::string const *));
+}
+
+TEST(SafeRefAllocatorTest, CopyAllocatesFromResource) {
+  counting_resource resource{};
+  std::pmr::string const test_value(1024, 'x', &resource);
+  auto const resource_allocations_before = resource.allocations;
+  auto const allocations_before = me_std::test::allocation_count();
+  {
+    me_std::pmr::safe_ref<std::pmr::string const &> const test_ref{test_value, &resource};
+    me_std::pmr::safe_ref<std::pmr::string const &> const copy_ref{test_ref};
+    me_std::pmr::safe_ref<std::pmr::string const &> const copy_copy_ref{copy_ref};
+
+    EXPECT_EQ(copy_ref.get_allocator().resource(), &resource);
+    EXPECT_EQ(copy_copy_ref.get_allocator().resource(), &resource);
+    EXPECT_EQ((*copy_copy_ref).get_allocator().resource(), &resource);
+    EXPECT_EQ(*copy_copy_ref, test_value);
+  }
+  EXPECT_EQ(allocations_before, me_std::test::allocation_count());
+  EXPECT_EQ(resource.allocations - resource_allocations_before, 4U);
+  EXPECT_EQ(resource.deallocations, 4U);
+}
+
+TEST(SafeRefAllocatorTest, CopyWithAllocator) {
+  counting_resource resource{};
+  std::pmr::string const test_value(1024, 'x');
+  me_std::pmr::safe_ref<std::pmr::string const &> const test_ref{test_value};
+  me_std::pmr::safe_ref<std::pmr::string const &> const copy_ref{test_ref, &resource};
+
+  EXPECT_EQ(test_ref.get_allocator().resource(), std::pmr::get_default_resource());
+  EXPECT_EQ(copy_ref.get_allocator().resource(), &resource);
+  EXPECT_EQ(resource.allocations, 2U);
+  EXPECT_EQ(*copy_ref, test_value);
+}
+
+TEST(SafeRefCompareTest, CompatibleTypes) {
+  std::string const test_value{"Hello World"};
+  me_std::safe_ref<std::string const &> const test_value_ref{test_value};
+  std::string_view const same_view{"Hello World"};
+  std::string_view const larger_view{"Oh, Hello World"};
+  std::optional<std::string_view> const larger_optional{larger_view};
+  std::optional<std::string> const empty_optional{};
+
+  auto const allocations_before = me_std::test::allocation_count();
+  EXPECT_TRUE(test_value_ref == same_view);
+  EXPECT_TRUE(same_view == test_value_ref);
+  EXPECT_TRUE(test_value_ref == "Hello World");
+  EXPECT_TRUE(test_value_ref != larger_view);
+  EXPECT_TRUE(test_value_ref < "Oh, Hello World");
+  EXPECT_TRUE(larger_view > test_value_ref);
+  EXPECT_TRUE(same_view <= test_value_ref);
+  EXPECT_TRUE(test_value_ref >= same_view);
+  EXPECT_TRUE(test_value_ref < larger_optional);
+  EXPECT_TRUE(larger_optional != test_value_ref);
+  EXPECT_TRUE(test_value_ref > empty_optional);
+  EXPECT_TRUE(empty_optional < test_value_ref);
+  EXPECT_FALSE(test_value_ref == empty_optional);
+  EXPECT_EQ(allocations_before, me_std::test::allocation_count());
+}
+
+#if defined(__cpp_lib_three_way_comparison)
+TEST(SafeRefThreeWayTest, OperatorSpaceship) {
+  std::string const test_value{"Hello World"};
+  std::string const larger_value{"Oh, Hello World"};
+  me_std::safe_ref<std::string const &> const test_value_ref{test_value};
+  me_std::safe_ref<std::string const &> const larger_value_ref{larger_value};
+
+  auto const allocations_before = me_std::test::allocation_count();
+  auto const order = test_value_ref <=> larger_value_ref;
+  auto const value_order = larger_value_ref <=> test_value;
+  auto const reversed_order = test_value <=> test_value_ref;
+  auto const view_order = test_value_ref <=> std::string_view{"Oh, Hello World"};
+  EXPECT_EQ(allocations_before, me_std::test::allocation_count());
+
+  EXPECT_TRUE(view_order < 0);
+
+  EXPECT_TRUE(order < 0);
+  EXPECT_TRUE(value_order > 0);
+  EXPECT_TRUE(reversed_order == 0);
+}
+#endif
+
 }  // namespace
@@ -0,0 +1,118 @@
+// Built into its own test executable with ME_STD_SAFE_REF_STATS defined, the
+// counting safe_ref must not meet a plain one within a program.
+#if !defined(ME_STD_SAFE_REF_STATS)
+#error "test.safe_ref_stats.cpp requires ME_STD_SAFE_REF_STATS"
+#endif
+
+#include <algorithm>
+#include <me_std/safe_ref.hpp>
+#include <me_std/safe_ref_stats.hpp>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <typeinfo>
+#include <utility>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace {
+
+struct large_value {
+  char data[64]{};
+};
+
+// The first dereference of a thread registers its counters, within a noexcept
+// operator*.
+static_assert(std::is_nothrow_constructible<me_std::detail::safe_ref_thread_counters,
+                                            std::type_info const &>::value);
+static_assert(noexcept(*std::declval<me_std::safe_ref<large_value const &> const &>()));
+
+class SafeRefStatsTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    me_std::set_safe_ref_stack_sampling(0);
+    me_std::safe_ref_stats_reset();
+  }
+  void TearDown() override { me_std::set_safe_ref_stack_sampling(0); }
+};
+
+TEST_F(SafeRefStatsTest, CountsCopiesAndDereferences) {
+  int value{42};
+  me_std::safe_ref<int const &> const test_ref{value};
+  me_std::safe_ref<int const &> const copy{test_ref};
+  EXPECT_EQ(*copy, 42);
+
+  auto const stats = me_std::safe_ref_stats_of<int>();
+  EXPECT_EQ(stats.type_name, typeid(int).name());
+  EXPECT_EQ(stats.copies, 1U);
+  EXPECT_EQ(stats.allocations, 0U);
+  EXPECT_EQ(stats.bytes, 0U);
+  // One to copy the referent, one by the test.
+  EXPECT_EQ(stats.dereferences, 2U);
+}
+
+TEST_F(SafeRefStatsTest, CountsHeapSnapshots) {
+  large_value value{};
+  me_std::safe_ref<large_value const &> const test_ref{value};
+  std::vector<me_std::safe_ref<large_value const &>> copies(3U, test_ref);
+
+  auto const stats = me_std::safe_ref_stats_of<large_value>();
+  EXPECT_EQ(stats.copies, 3U);
+  EXPECT_EQ(stats.allocations, 3U);
+  EXPECT_EQ(stats.bytes, 3U * sizeof(large_value));
+  EXPECT_EQ(me_std::safe_ref_stats_of<int>().copies, 0U);
+}
+
+TEST_F(SafeRefStatsTest, AggregatesThreads) {
+  std::string value{"Hello World"};
+  me_std::safe_ref<std::string const &> const test_ref{value};
+  std::vector<std::thread> threads{};
+  for (int thread = 0; thread < 4; ++thread) {
+    threads.emplace_back([&test_ref] {
+      for (int copy = 0; copy < 10; ++copy) {
+        me_std::safe_ref<std::string const &> const local{test_ref};
+        static_cast<void>(local);
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  me_std::safe_ref<std::string const &> const local{test_ref};
+
+  EXPECT_EQ(me_std::safe_ref_stats_of<std::string>().copies, 41U);
+
+  auto const all = me_std::safe_ref_stats_snapshot();
+  auto const strings = std::find_if(all.begin(), all.end(), [](auto const &stats) {
+    return stats.type_name == typeid(std::string).name();
+  });
+  ASSERT_NE(strings, all.end());
+  EXPECT_EQ(strings->copies, 41U);
+}
+
+TEST_F(SafeRefStatsTest, SamplesStacks) {
+  large_value value{};
+  me_std::safe_ref<large_value const &> const test_ref{value};
+  me_std::set_safe_ref_stack_sampling(2);
+  for (int copy = 0; copy < 8; ++copy) {
+    me_std::safe_ref<large_value const &> const local{test_ref};
+    static_cast<void>(local);
+  }
+
+  auto const samples = me_std::safe_ref_stack_samples();
+#if __has_include(<execinfo.h>)
+  ASSERT_FALSE(samples.empty());
+  EXPECT_EQ(samples.front().type_name, typeid(large_value).name());
+  EXPECT_FALSE(samples.front().frames.empty());
+  std::uint64_t copies{0};
+  for (auto const &sample : samples) {
+    copies += sample.copies;
+  }
+  EXPECT_EQ(copies, 4U);
+#else
+  EXPECT_TRUE(samples.empty());
+#endif
+}
+
+}  // namespace